@@ -0,0 +1,135 @@
+/**
+ * Bioinformatics Toolsmith Laboratory, University of Tulsa
+ **/
+
+#include <algorithm>
+#include <vector>
+#include <stdint.h>
+#include <stdlib.h>
+#include "EditAlignE.h"
+
+using namespace std;
+using namespace utility;
+
+EditAlignE::EditAlignE(const char * seq1In, int start1In, int end1In,
+        const char * seq2In, int start2In, int end2In){
+    seq1 = seq1In;
+    start1 = start1In;
+    end1 = end1In;
+
+    seq2 = seq2In;
+    start2 = start2In;
+    end2 = end2In;
+
+    len1 = end1 - start1 + 1;
+    len2 = end2 - start2 + 1;
+
+    findDistance();
+}
+
+/**
+ * The second sequence runs down the rows and is packed into blocks of 64
+ * rows; the first sequence is read one column at a time. Each block keeps
+ * the vertical deltas of its rows (Pv for +1, Mv for -1) and the value of
+ * its last row. The first row of a global alignment grows by one per
+ * column, so every column enters the top block with a horizontal delta of
+ * +1.
+ */
+void EditAlignE::findDistance(){
+    if (len1 <= 0 || len2 <= 0){
+        distance = max(len1, 0) + max(len2, 0);
+        return;
+    }
+
+    const int blocks = (len2 + 63) / 64;
+    const uint64_t ones = ~(uint64_t) 0;
+
+    // One match mask per byte value and block
+    vector<uint64_t> peq(256 * blocks, 0);
+    for (int i = 0; i < len2; i++){
+        unsigned char c = seq2[start2 + i];
+        peq[c * blocks + i / 64] |= (uint64_t) 1 << (i % 64);
+    }
+
+    vector<uint64_t> pv(blocks, ones);
+    vector<uint64_t> mv(blocks, 0);
+    vector<int> score(blocks);
+    vector<uint64_t> high(blocks, (uint64_t) 1 << 63);
+    for (int b = 0; b < blocks; b++){
+        score[b] = min((b + 1) * 64, len2);
+    }
+    high[blocks - 1] = (uint64_t) 1 << ((len2 - 1) % 64);
+
+    for (int j = 0; j < len1; j++){
+        const uint64_t * eqColumn = &peq[(unsigned char) seq1[start1 + j] * blocks];
+        int hin = 1;
+        for (int b = 0; b < blocks; b++){
+            uint64_t eq = eqColumn[b];
+            uint64_t p = pv[b];
+            uint64_t m = mv[b];
+
+            uint64_t xv = eq | m;
+            if (hin < 0){
+                eq |= 1;
+            }
+            uint64_t xh = (((eq & p) + p) ^ p) | eq;
+            uint64_t ph = m | ~(xh | p);
+            uint64_t mh = p & xh;
+
+            int hout = 0;
+            if (ph & high[b]){
+                hout = 1;
+            }
+            else if (mh & high[b]){
+                hout = -1;
+            }
+
+            ph <<= 1;
+            mh <<= 1;
+            if (hin < 0){
+                mh |= 1;
+            }
+            else if (hin > 0){
+                ph |= 1;
+            }
+            pv[b] = mh | ~(xv | ph);
+            mv[b] = ph & xv;
+
+            score[b] += hout;
+            hin = hout;
+        }
+    }
+
+    distance = score[blocks - 1];
+}
+
+int EditAlignE::getDistance(){
+    return distance;
+}
+
+/**
+ * A coarse estimate of the identity, for ordering pairs.
+ */
+double EditAlignE::getIdentity(){
+    int longer = max(len1, len2);
+    if (longer <= 0){
+        return 1.0;
+    }
+    return 1.0 - (double) distance / longer;
+}
+
+/**
+ * No global alignment has a higher identity. One with g gap columns and
+ * x mismatches needs g + x >= distance and g >= |len1 - len2|; it has
+ * (len1 + len2 - g) / 2 - x matches over (len1 + len2 + g) / 2 columns,
+ * which is largest when g is the larger of the two and x makes up the
+ * rest.
+ */
+double EditAlignE::getIdentityBound(){
+    int total = len1 + len2;
+    if (total <= 0){
+        return 1.0;
+    }
+    int gaps = max(distance, abs(len1 - len2));
+    return (double) (total - gaps) / (total + gaps);
+}
@@ -0,0 +1,44 @@
+/**
+ * Bioinformatics Toolsmith Laboratory, University of Tulsa
+ *
+ * Unit-cost global edit distance computed with the bit-vector algorithm of
+ * Myers (1999), in the block form of Hyyro (2003): each column of the
+ * dynamic-programming matrix is kept as vertical +1/-1 bit vectors, 64 rows
+ * per machine word, so a pair of lengths n and m costs n * ceil(m / 64)
+ * word operations.
+ *
+ * The edit distance bounds the identity of every global alignment of the
+ * two sequences, including the affine one of GlobAlignE, from above.
+ **/
+
+#ifndef EDIT_ALIGNE_H_
+#define EDIT_ALIGNE_H_
+#include <string>
+
+using namespace std;
+
+namespace utility{
+
+class EditAlignE{
+
+private:
+    const char * seq1; //first sequence to be aligned
+    int start1;
+    int end1;
+    const char * seq2;//second sequence to be aligned
+    int start2;
+    int end2;
+    int len1;
+    int len2;
+    int distance;
+
+    void findDistance();
+
+public:
+    EditAlignE(const char*,int,int,const char *,int,int);
+    int getDistance();
+    double getIdentity();
+    double getIdentityBound();
+};
+}
+#endif
@@ -20,7 +20,8 @@ using namespace utility;
 using namespace exception;
 
 GlobAlignE::GlobAlignE(const char * seq1In, int start1In, int end1In, const char * seq2In,
-        int start2In, int end2In, int matchIn, int mismatchIn, int gapOpenIn, int gapContinueIn){
+        int start2In, int end2In, int matchIn, int mismatchIn, int gapOpenIn, int gapContinueIn,
+        double cutoffIn){
 
     seq1 = seq1In;
 	start1 = start1In;
@@ -33,30 +34,48 @@ GlobAlignE::GlobAlignE(const char * seq1In, int start1In, int end1In, const char
 	len1 = end1 - start1 + 2;
     len2 = end2 - start2 + 2;
 
-    //Incremental score storage
-    matches = new int[len1];
-    upperGap = new int[len1];
-    lowerGap = new int[len1];
-
-    //Incremental length storage
-    matchLen = new int[len1];
-    upperLen = new int[len1];
-    lowerLen = new int[len1];
-
-    //Incremental identity storage
-    matchId = new int[len1];
-    upperId = new int[len1];
-    lowerId = new int[len1];
-
     match = matchIn;
     mismatch = mismatchIn;
     gapOpen = gapOpenIn;
     gapContinue = gapContinueIn;
-    findAlignment();
+    findAlignment(cutoffIn);
 
 } 
 
 void GlobAlignE::findAlignment(){
+    findAlignment(-1.0);
+}
+
+// Rounds x / 2 toward negative infinity
+static int floorHalf(int x){
+    return x >= 0 ? x / 2 : -((1 - x) / 2);
+}
+
+// Rounds x / 2 toward positive infinity
+static int ceilHalf(int x){
+    return -floorHalf(-x);
+}
+
+/**
+ * With a cutoff in (0, 1], only the answer to "is the identity below the
+ * cutoff?" has to be exact. An alignment with g gap columns has at most
+ * (n + m - g) / 2 identical pairs and (n + m + g) / 2 columns, so if its
+ * identity reaches the cutoff, g is at most (n + m)(1 - c) / (1 + c). A
+ * path that wanders k diagonals away has at least |k| + |m - n - k| gap
+ * columns, which gives the band of diagonals to fill.
+ *
+ * If the optimal alignment reaches the cutoff it lies in the band, and the
+ * banded fill finds it with the same score, length and identity. So a
+ * banded identity below the cutoff proves that the full one is below it
+ * too. A banded identity at or above the cutoff is exact only if no path
+ * leaving the band can score as high; otherwise the full matrix is filled.
+ */
+void GlobAlignE::findAlignment(double cutoff){
+    alignmentScore = 0;
+    alignmentLength = 0;
+    totalMatches = 0;
+    isExact = true;
+    identityBound = 0.0;
 
     int shorter = min(len2,len1)-1;
     int lenDiff = abs(len2-len1);
@@ -70,161 +89,322 @@ void GlobAlignE::findAlignment(){
 
     const int negativeInf = maxDiff; 
 
-    matches[0]= 0;
-    upperGap[0] = negativeInf;
-    lowerGap[0] = negativeInf;
-    
-    matchLen[0] =0;
-    upperLen[0] =0;
-    lowerLen[0] =0;
-
-    matchId[0] =0;
-    upperId[0] = 0;
-    lowerId[0] =0;
-  
-    //initial values 
-    for (int i = 1; i<len1;i++){ 
-        upperGap[i] = negativeInf;
-        matches[i] = negativeInf;
-        lowerGap[i] = (-gapOpen)- (i*gapContinue);
-        matchLen[i]=i; 
-        upperLen[i]=i;
-        lowerLen[i]=i;
-        matchId[i] =0;
-        upperId[i] =0;
-        lowerId[i] =0;
-    }
-   
-    for( int j = 1;j<len2;j++){ 
-        
-        int matchLag = matches[0]; //used for calculation of matches
-        int matchLenLag = matchLen[0];
-        int matchIdLag = matchId[0];
-        
-        int upperGapLag = (-gapOpen)-((j-1)*gapContinue); 
-        int upperLenLag = j-1;
-        int upperIdLag =0;
-
-        for(int i =1;i<len1;i++){
-           
-            //compute values for upperGap
-            int ygapBegin = matches[i]-(gapOpen+gapContinue);
-            int ygapCont = upperGap[i]-gapContinue;
-    
-            int ans = max(ygapBegin,ygapCont);
-            
-            int store1 = upperGap[i];
-            int store2 = upperLen[i];
-            int store3 = upperId[i];
-            
-            upperGap[i] = ans;
-            
-            if( ans == ygapBegin){
-                upperLen[i] = matchLen[i]+1;
-                upperId[i] = matchId[i];
-            }
-            else if(ans == ygapCont){
-                upperLen[i] = upperLen[i]+1;
-                upperId[i] = upperId[i]; //Joseph: What is this?
-            }
+    // Every score is within this distance of zero: each step changes a score
+    // by at most one gap opening plus one substitution, and each path has at
+    // most len1 + len2 steps. Lengths and identities are smaller still.
+    long step = abs(match) + abs(mismatch) + abs(gapOpen) + abs(gapContinue);
+    long total = len1 + len2 + 2;
+    const int n = len1 - 1;
+    const int m = len2 - 1;
 
+    bool isBanded = cutoff > 0 && cutoff <= 1 && n > 0 && m > 0
+            && gapOpen >= 0 && gapContinue >= 0;
+    if (!isBanded){
+        long bound = labs(negativeInf) + 2 * step * total;
+        if (bound < SHRT_MAX){
+            findAlignmentDiagonal<short>(negativeInf, -n, m, 0, 0, -1.0);
+        }
+        else{
+            findAlignmentDiagonal<int>(negativeInf, -n, m, 0, 0, -1.0);
+        }
+        return;
+    }
 
-            // compute values for match/mismatch
-            char a= seq1[start1+i-1];
-            char b = seq2[start2+j-1];
-            int matchScore = (a == b) ? match : mismatch;
-            
-            int matched = matchLag + matchScore;
-            
-            int xgapEnd = lowerGap[i-1] + matchScore;
-            
-            int ygapEnd = upperGapLag+ matchScore;
-    
-            ans = max(max(matched,xgapEnd),ygapEnd);
-           
-            matchLag = matches[i]; //store current val matches in lag
-            matches[i] =ans;
-           
-            int temp = matchLen[i];
-            int save = matchId[i];
-
-            if(ans == matched){
-                matchLen[i] = matchLenLag+1;
-                if(matchScore == match){
-                    matchId[i] = matchIdLag+1;
-                }
-                else{
-                    matchId[i] = matchIdLag;
-                }
-            }
-            else if (ans == xgapEnd){
-                matchLen[i] = lowerLen[i-1]+1;
-                if(matchScore ==match){
-                    matchId[i] = lowerId[i-1]+1;
-                }
-                else{
-                    matchId[i] = lowerId[i-1];
+    const int maxGaps = (int) floor((n + m) * (1 - cutoff) / (1 + cutoff) + 1e-9);
+    if (maxGaps < abs(m - n)){
+        // Even the best arrangement of the shorter sequence falls short
+        isExact = false;
+        identityBound = min((double) min(n, m) / max(n, m), nextafter(cutoff, 0.0));
+        return;
+    }
+    const int bandLow = ceilHalf(m - n - maxGaps);
+    const int bandHigh = floorHalf(m - n + maxGaps);
+
+    // Each column lowers a score by at most drop, so every score reachable
+    // from the first row or column is at least reachable. Cells next to the
+    // band hold padding, low enough that no path through them can catch up
+    // with a reachable score.
+    const long drop = max(max(abs(match), abs(mismatch)), gapOpen + gapContinue);
+    const int reachable = min(negativeInf, 0) - drop * total;
+    const int padding = reachable - max(max(match, mismatch), 0) * min(n, m) - 1;
+    long bound = labs(padding) + drop * total;
+    bool isFilled;
+    if (bound < SHRT_MAX){
+        isFilled = findAlignmentDiagonal<short>(negativeInf, bandLow, bandHigh,
+                padding, reachable, cutoff);
+    }
+    else{
+        isFilled = findAlignmentDiagonal<int>(negativeInf, bandLow, bandHigh,
+                padding, reachable, cutoff);
+    }
+    if (!isFilled){
+        return;
+    }
+
+    double identity = (double) totalMatches / alignmentLength;
+    if (identity < cutoff){
+        isExact = false;
+        identityBound = identity;
+        return;
+    }
+
+    // A path leaving the band has more than maxGaps gap columns, or starts
+    // from one of the negativeInf boundary states
+    double best = max(match, mismatch);
+    double outside = max(best * (n + m - maxGaps - 1) / 2 - gapOpen
+            - gapContinue * (maxGaps + 1.0), -gapOpen - gapContinue * (double) (n + m));
+    outside = max(outside, negativeInf + max(best, 0.0) * min(n, m));
+    if (alignmentScore <= outside){
+        findAlignment(-1.0);
+    }
+}
+
+/**
+ * Affine-gap global alignment with three states per cell: match, upper
+ * (gap in the first sequence) and lower (gap in the second sequence), each
+ * carrying its score, alignment length and number of identical pairs.
+ *
+ * The matrix is filled one anti-diagonal at a time. A cell (i, j) needs
+ * (i - 1, j - 1) for the match state, (i, j - 1) for the upper state and
+ * (i - 1, j) for the lower state, which all lie on the two previous
+ * anti-diagonals, so the cells of one anti-diagonal are independent and
+ * the inner loop vectorizes. Cells are stored by their row i; on
+ * anti-diagonal d, j = d - i.
+ *
+ * S is the lane type: short when every value fits, which packs twice as
+ * many cells per vector register, and int otherwise. Ties between the
+ * states are broken in the order match, lower, upper.
+ *
+ * Only cells with bandLow <= j - i <= bandHigh are filled; their outside
+ * neighbors hold the padding score. With a cutoff of zero or more, every
+ * eighth anti-diagonal bounds the identity any alignment through it can
+ * still reach, and the fill stops, returning false, once that bound falls
+ * below the cutoff.
+ */
+template<class S>
+bool GlobAlignE::findAlignmentDiagonal(int negativeInf, int bandLow, int bandHigh,
+        int padding, int reachable, double cutoff){
+    enum {SM, SU, SL, LM, LU, LL, IM, IU, IL, STATES};
+
+    const int rows = len1;
+    const int cols = len2;
+    const S openCost = gapOpen + gapContinue;
+    const S contCost = gapContinue;
+    const S matchScoreIn = match;
+    const S mismatchScoreIn = mismatch;
+
+    // Three anti-diagonals (d, d - 1, d - 2) of all nine quantities
+    vector<S> buffer(3 * STATES * rows);
+    S * cur[STATES];
+    S * p1[STATES];
+    S * p2[STATES];
+    for (int k = 0; k < STATES; k++){
+        cur[k] = &buffer[(0 * STATES + k) * rows];
+        p1[k] = &buffer[(1 * STATES + k) * rows];
+        p2[k] = &buffer[(2 * STATES + k) * rows];
+    }
+
+    // The second sequence is reversed so that both sequences are read
+    // forward along an anti-diagonal
+    vector<char> reversed(cols);
+    for (int k = 0; k < cols - 1; k++){
+        reversed[k] = seq2[start2 + cols - 2 - k];
+    }
+    const char * a = seq1 + start1 - 1;
+
+    // The best identity of a complete alignment through the reachable
+    // states of anti-diagonal d, rows from to to
+    auto bestReach = [&](S * const * v, int from, int to, int d){
+        double reach = 0.0;
+        for (int i = from; i <= to; i++){
+            int restRows = rows - 1 - i;
+            int restCols = cols - 1 - (d - i);
+            int restMin = min(restRows, restCols);
+            int restMax = max(restRows, restCols);
+            const int states[3][3] = {{SM, LM, IM}, {SU, LU, IU}, {SL, LL, IL}};
+            for (int k = 0; k < 3; k++){
+                if (v[states[k][0]][i] >= reachable){
+                    double r = (double) (v[states[k][2]][i] + restMin)
+                            / (v[states[k][1]][i] + restMax);
+                    reach = max(reach, r);
                 }
             }
-            else{
-                matchLen[i] = upperLenLag+1;
-                if(matchScore ==match){
-                matchId[i] = upperIdLag+1;
-                }
-                else{
-                    matchId[i] = upperIdLag;
-                }
+        }
+        return reach;
+    };
+
+    int prevLo = 0;
+    int prevHi = -1;
+    const int lastDiagonal = rows + cols - 2;
+    for (int d = 0; d <= lastDiagonal; d++){
+        int lo = max(0, d - (cols - 1));
+        int hi = min(rows - 1, d);
+
+        // The next two anti-diagonals read at most one cell past each end
+        // of the band
+        const int bandFirst = ceilHalf(d - bandHigh);
+        const int bandLast = floorHalf(d - bandLow);
+        const int padded[2] = {bandFirst - 1, bandLast + 1};
+        for (int k = 0; k < 2; k++){
+            int i = padded[k];
+            if (i >= lo && i <= hi){
+                cur[SM][i] = padding;
+                cur[SU][i] = padding;
+                cur[SL][i] = padding;
+                cur[LM][i] = 0;
+                cur[LU][i] = 0;
+                cur[LL][i] = 0;
+                cur[IM][i] = 0;
+                cur[IU][i] = 0;
+                cur[IL][i] = 0;
             }
-            matchLenLag = temp;
-            matchIdLag = save;
-            upperGapLag= store1;
-            upperLenLag = store2;
-            upperIdLag = store3;
- 
         }
-    
-        matches[0] = negativeInf;
-        matchLen[0] = j;
-        matchId[0] =0;
-       
-        lowerGap[0]= negativeInf;
-        lowerLen[0] = j;
-        lowerId[0] =0;
-        
-        for(int i = 1;i<len1;i++){
-                
-                int xgapBegin = matches[i-1] -(gapOpen+gapContinue);
-                int xgapCont = lowerGap[i-1]- gapContinue;
-                int ans = max(xgapBegin,xgapCont); 
-                lowerGap[i]=ans;
-                if(ans ==xgapBegin){
-                    lowerLen[i] = matchLen[i-1]+1;
-                    lowerId[i] = matchId[i-1];
-                }
-                else{
-                    lowerLen[i] = lowerLen[i-1]+1;
-                    lowerId[i] = lowerId[i-1];
-                }
-           
+        lo = max(lo, bandFirst);
+        hi = min(hi, bandLast);
+
+        // First row: only gaps in the first sequence reach it
+        if (lo == 0){
+            cur[SM][0] = (d == 0) ? 0 : negativeInf;
+            cur[SU][0] = -gapOpen - d * gapContinue;
+            cur[SL][0] = negativeInf;
+            cur[LM][0] = d;
+            cur[LU][0] = d;
+            cur[LL][0] = d;
+            cur[IM][0] = 0;
+            cur[IU][0] = 0;
+            cur[IL][0] = 0;
+        }
+        // First column: only gaps in the second sequence reach it
+        if (hi == d && d >= 1){
+            cur[SM][d] = negativeInf;
+            cur[SU][d] = negativeInf;
+            cur[SL][d] = -gapOpen - d * gapContinue;
+            cur[LM][d] = d;
+            cur[LU][d] = d;
+            cur[LL][d] = d;
+            cur[IM][d] = 0;
+            cur[IU][d] = 0;
+            cur[IL][d] = 0;
+        }
+
+        const char * b = reversed.data() + (cols - 1 - d);
+        const int first = max(lo, 1);
+        const int last = min(hi, d - 1);
+
+        S * __restrict cSM = cur[SM];
+        S * __restrict cSU = cur[SU];
+        S * __restrict cSL = cur[SL];
+        S * __restrict cLM = cur[LM];
+        S * __restrict cLU = cur[LU];
+        S * __restrict cLL = cur[LL];
+        S * __restrict cIM = cur[IM];
+        S * __restrict cIU = cur[IU];
+        S * __restrict cIL = cur[IL];
+        const S * __restrict pSM = p1[SM];
+        const S * __restrict pSU = p1[SU];
+        const S * __restrict pSL = p1[SL];
+        const S * __restrict pLM = p1[LM];
+        const S * __restrict pLU = p1[LU];
+        const S * __restrict pLL = p1[LL];
+        const S * __restrict pIM = p1[IM];
+        const S * __restrict pIU = p1[IU];
+        const S * __restrict pIL = p1[IL];
+        const S * __restrict qSM = p2[SM];
+        const S * __restrict qSU = p2[SU];
+        const S * __restrict qSL = p2[SL];
+        const S * __restrict qLM = p2[LM];
+        const S * __restrict qLU = p2[LU];
+        const S * __restrict qLL = p2[LL];
+        const S * __restrict qIM = p2[IM];
+        const S * __restrict qIU = p2[IU];
+        const S * __restrict qIL = p2[IL];
+
+        // Every value is loaded and the choices are made with bit masks
+        // (all ones or all zeros), so the loop body has no branches
+#pragma omp simd
+        for (int i = first; i <= last; i++){
+            S same = -(S) (a[i] == b[i]);
+            S matchScore = (matchScoreIn & same) | (mismatchScoreIn & ~same);
+            S isMatch = -(S) (matchScore == matchScoreIn);
+
+            // Upper gap, from (i, j - 1)
+            S ygapBegin = pSM[i] - openCost;
+            S ygapCont = pSU[i] - contCost;
+            S upperFromMatch = -(S) (ygapBegin >= ygapCont);
+            cSU[i] = (ygapBegin & upperFromMatch) | (ygapCont & ~upperFromMatch);
+            cLU[i] = ((pLM[i] & upperFromMatch) | (pLU[i] & ~upperFromMatch)) + 1;
+            cIU[i] = (pIM[i] & upperFromMatch) | (pIU[i] & ~upperFromMatch);
+
+            // Match/mismatch, from (i - 1, j - 1)
+            S matched = qSM[i - 1] + matchScore;
+            S xgapEnd = qSL[i - 1] + matchScore;
+            S ygapEnd = qSU[i - 1] + matchScore;
+            S ans = matched > xgapEnd ? matched : xgapEnd;
+            ans = ans > ygapEnd ? ans : ygapEnd;
+            S fromMatch = -(S) (ans == matched);
+            S fromLower = -(S) (ans == xgapEnd);
+            S gapLen = (qLL[i - 1] & fromLower) | (qLU[i - 1] & ~fromLower);
+            S gapId = (qIL[i - 1] & fromLower) | (qIU[i - 1] & ~fromLower);
+            cSM[i] = ans;
+            cLM[i] = ((qLM[i - 1] & fromMatch) | (gapLen & ~fromMatch)) + 1;
+            cIM[i] = ((qIM[i - 1] & fromMatch) | (gapId & ~fromMatch)) - isMatch;
+
+            // Lower gap, from (i - 1, j)
+            S xgapBegin = pSM[i - 1] - openCost;
+            S xgapCont = pSL[i - 1] - contCost;
+            S lowerFromMatch = -(S) (xgapBegin >= xgapCont);
+            cSL[i] = (xgapBegin & lowerFromMatch) | (xgapCont & ~lowerFromMatch);
+            cLL[i] = ((pLM[i - 1] & lowerFromMatch) | (pLL[i - 1] & ~lowerFromMatch)) + 1;
+            cIL[i] = (pIM[i - 1] & lowerFromMatch) | (pIL[i - 1] & ~lowerFromMatch);
+        }
+
+        if (cutoff >= 0 && d > 0 && d % 8 == 0){
+            // Every path passes through anti-diagonal d or d - 1
+            double reach = max(bestReach(cur, lo, hi, d),
+                    bestReach(p1, prevLo, prevHi, d - 1));
+            if (reach < cutoff){
+                isExact = false;
+                identityBound = reach;
+                return false;
+            }
         }
+        prevLo = lo;
+        prevHi = hi;
 
-     
+        for (int k = 0; k < STATES; k++){
+            S * temp = p2[k];
+            p2[k] = p1[k];
+            p1[k] = cur[k];
+            cur[k] = temp;
+        }
     }
 
-   alignmentScore= max(max(matches[len1-1], lowerGap[len1-1]), upperGap[len1-1]);
+    // The last cell is now on the previous anti-diagonal
+    const int i = rows - 1;
+    int upperScore = p1[SU][i];
+    int upperLength = p1[LU][i];
+    int upperIdentity = p1[IU][i];
+    if (rows == 1){
+        // The upper state of the first row is never filled
+        upperScore = negativeInf;
+        upperLength = 0;
+        upperIdentity = 0;
+    }
 
-   if(alignmentScore == matches[len1-1]){
-           alignmentLength = matchLen[len1-1];
-           totalMatches = matchId[len1-1];
+    alignmentScore = max(max((int) p1[SM][i], (int) p1[SL][i]), upperScore);
+    if (alignmentScore == p1[SM][i]){
+        alignmentLength = p1[LM][i];
+        totalMatches = p1[IM][i];
     }
-    else if(alignmentScore == lowerGap[len1-1]){
-            alignmentLength = lowerLen[len1-1];
-            totalMatches= lowerId[len1-1];
+    else if (alignmentScore == p1[SL][i]){
+        alignmentLength = p1[LL][i];
+        totalMatches = p1[IL][i];
     }
     else{
-            alignmentLength = upperLen[len1-1];
-            totalMatches = upperId[len1-1];
+        alignmentLength = upperLength;
+        totalMatches = upperIdentity;
     }
+    return true;
 }
 
 int GlobAlignE::getScore(){
@@ -235,19 +415,12 @@ int GlobAlignE::getLength(){
 }
 
 double GlobAlignE::getIdentity(){
+    if (!isExact){
+        return identityBound;
+    }
    double totalMatch = (double) totalMatches;
 
     return totalMatch/alignmentLength;
 }
 GlobAlignE::~GlobAlignE(){
-    delete [] matches;
-    delete [] upperGap;
-    delete [] lowerGap;
-    delete [] matchLen;
-    delete [] upperLen;
-    delete [] lowerLen;
-    delete [] matchId;
-    delete [] upperId;
-    delete [] lowerId;
-    
 }
@@ -28,23 +28,26 @@ private:
     int mismatch;//score for base pair mismatch
     int gapOpen; //cost to open a gap
     int gapContinue; //cost to continue a gap
-    int * matches;
-    int * upperGap;
-    int * lowerGap;
-    int * matchLen;
-    int * upperLen;
-    int * lowerLen;
-    int * matchId;
-    int * upperId;
-    int * lowerId;
     int alignmentScore;
     int alignmentLength;
     int totalMatches;
+    bool isExact; //false when only a bound below the cutoff is known
+    double identityBound;
     string topString; 
     string bottomString;
 
+    void findAlignment(double);
+    template<class S>
+    bool findAlignmentDiagonal(int, int, int, int, int, double);
+
 public:
-    GlobAlignE(const char*,int,int,const char *,int,int, int,int,int,int);
+    /**
+     * With a cutoff in (0, 1], a band around the main diagonal is aligned
+     * and the identity is exact whenever it is at least the cutoff. Below
+     * the cutoff, getIdentity may return an upper bound that is still below
+     * the cutoff, and the score and length are not meaningful.
+     */
+    GlobAlignE(const char*,int,int,const char *,int,int, int,int,int,int, double = -1.0);
     virtual ~GlobAlignE();
     void findAlignment();
     double getIdentity();
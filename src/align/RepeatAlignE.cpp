@@ -19,11 +19,11 @@ namespace motif{
   void RepeatAlignE::alignRepeatWithBackTracking(){
     std::transform(seq.begin(), seq.end(),seq.begin(), ::toupper);
     std::string b = seq;
-    int * rowA = (int*) calloc(1, sizeof(int));
+    int * rowA = new int[1]();
     int * rowB;
     rowA[0] = 0;
     for(int i = 1; i < seq.size(); i++){
-      rowB = (int*) calloc(i + 1, sizeof(int));
+      rowB = new int[i + 1]();
       rowB[0] = 0;
       for(int j = 1; j < i; j++){
        int s;
@@ -38,7 +38,7 @@ namespace motif{
      delete[] rowA;
      rowA = rowB;
    }
-   cost = rowB;
+   cost = rowA;
  }
  
   /*
@@ -0,0 +1,209 @@
+/**
+ * Bioinformatics Toolsmith Laboratory, University of Tulsa
+ **/
+
+#include <algorithm>
+#include <vector>
+#include <limits.h>
+#include "WrapAlignE.h"
+
+using namespace std;
+using namespace utility;
+
+WrapAlignE::WrapAlignE(const char * seqIn, int startIn, int endIn, const string& motifIn,
+        int matchIn, int mismatchIn, int gapOpenIn, int gapContinueIn, double cutoffIn){
+    seq = seqIn;
+    start = startIn;
+    end = endIn;
+    motif = motifIn;
+
+    match = matchIn;
+    mismatch = mismatchIn;
+    gapOpen = gapOpenIn;
+    gapContinue = gapContinueIn;
+    findAlignment(cutoffIn);
+}
+
+/**
+ * Row i holds the alignments of the first i characters of the region; the
+ * cell in column j ends at motif position j. Column j - 1 of column 1 is
+ * column p = |motif| of the previous copy of the motif, so the match and
+ * lower states read the previous row cyclically.
+ *
+ * The upper state (a gap in the region) is cyclic within a row, since it
+ * moves along the motif. The match state of a row does not depend on it,
+ * so the match row is filled first and the upper state is then swept
+ * around the row twice: a gap never gains from going all the way around.
+ *
+ * Ties between the states are broken in the order match, lower, upper, as
+ * in GlobAlignE. Among the last cells, ties go to the higher identity, so
+ * that every rotation of the motif gets the same result.
+ */
+void WrapAlignE::findAlignment(double cutoff){
+    alignmentScore = 0;
+    alignmentLength = 0;
+    totalMatches = 0;
+    isExact = true;
+    identityBound = 0.0;
+
+    const int n = end - start + 1;
+    const int p = motif.size();
+    if (n <= 0 || p == 0){
+        return;
+    }
+
+    const int negativeInf = INT_MIN / 2;
+    const int openCost = gapOpen + gapContinue;
+    enum {SM, SU, SL, LM, LU, LL, IM, IU, IL, STATES};
+
+    // Two rows of the nine quantities, columns 0 to p - 1
+    vector<int> buffer(2 * STATES * p);
+    int * cur[STATES];
+    int * prev[STATES];
+    for (int k = 0; k < STATES; k++){
+        prev[k] = &buffer[k * p];
+        cur[k] = &buffer[(STATES + k) * p];
+    }
+
+    // The repeat may start anywhere in the motif at no cost
+    for (int j = 0; j < p; j++){
+        prev[SM][j] = 0;
+        prev[SU][j] = negativeInf;
+        prev[SL][j] = negativeInf;
+        prev[LM][j] = 0;
+        prev[LU][j] = 0;
+        prev[LL][j] = 0;
+        prev[IM][j] = 0;
+        prev[IU][j] = 0;
+        prev[IL][j] = 0;
+    }
+
+    for (int i = 1; i <= n; i++){
+        const char c = seq[start + i - 1];
+
+        for (int j = 0; j < p; j++){
+            const int d = (j == 0) ? p - 1 : j - 1;
+
+            // Match/mismatch, from (i - 1, j - 1)
+            int matchScore = (c == motif[j]) ? match : mismatch;
+            int isMatch = (matchScore == match) ? 1 : 0;
+            int matched = prev[SM][d] + matchScore;
+            int xgapEnd = prev[SL][d] + matchScore;
+            int ygapEnd = prev[SU][d] + matchScore;
+            int ans = max(max(matched, xgapEnd), ygapEnd);
+            cur[SM][j] = ans;
+            if (ans == matched){
+                cur[LM][j] = prev[LM][d] + 1;
+                cur[IM][j] = prev[IM][d] + isMatch;
+            }
+            else if (ans == xgapEnd){
+                cur[LM][j] = prev[LL][d] + 1;
+                cur[IM][j] = prev[IL][d] + isMatch;
+            }
+            else{
+                cur[LM][j] = prev[LU][d] + 1;
+                cur[IM][j] = prev[IU][d] + isMatch;
+            }
+
+            // Lower gap, from (i - 1, j): the region character is unaligned
+            int xgapBegin = prev[SM][j] - openCost;
+            int xgapCont = prev[SL][j] - gapContinue;
+            if (xgapBegin >= xgapCont){
+                cur[SL][j] = xgapBegin;
+                cur[LL][j] = prev[LM][j] + 1;
+                cur[IL][j] = prev[IM][j];
+            }
+            else{
+                cur[SL][j] = xgapCont;
+                cur[LL][j] = prev[LL][j] + 1;
+                cur[IL][j] = prev[IL][j];
+            }
+        }
+
+        // Upper gap, from (i, j - 1): the motif character is skipped
+        for (int j = 0; j < p; j++){
+            cur[SU][j] = negativeInf;
+        }
+        for (int lap = 0; lap < 2; lap++){
+            for (int j = 0; j < p; j++){
+                const int d = (j == 0) ? p - 1 : j - 1;
+                int ygapBegin = cur[SM][d] - openCost;
+                int ygapCont = cur[SU][d] - gapContinue;
+                int score = max(ygapBegin, ygapCont);
+                if (lap == 1 && score == cur[SU][j]){
+                    break;
+                }
+                cur[SU][j] = score;
+                if (ygapBegin >= ygapCont){
+                    cur[LU][j] = cur[LM][d] + 1;
+                    cur[IU][j] = cur[IM][d];
+                }
+                else{
+                    cur[LU][j] = cur[LU][d] + 1;
+                    cur[IU][j] = cur[IU][d];
+                }
+            }
+        }
+
+        // Each of the rest characters adds one column and at most one pair
+        if (cutoff > 0 && (i % 8 == 0)){
+            const int rest = n - i;
+            double reach = 0.0;
+            const int states[3][3] = {{SM, LM, IM}, {SU, LU, IU}, {SL, LL, IL}};
+            for (int j = 0; j < p; j++){
+                for (int k = 0; k < 3; k++){
+                    if (cur[states[k][0]][j] > negativeInf / 2){
+                        double r = (double) (cur[states[k][2]][j] + rest)
+                                / (cur[states[k][1]][j] + rest);
+                        reach = max(reach, r);
+                    }
+                }
+            }
+            if (reach < cutoff){
+                isExact = false;
+                identityBound = reach;
+                return;
+            }
+        }
+
+        for (int k = 0; k < STATES; k++){
+            swap(cur[k], prev[k]);
+        }
+    }
+
+    // The repeat may stop anywhere in the motif at no cost
+    alignmentScore = negativeInf;
+    alignmentLength = 1;
+    for (int j = 0; j < p; j++){
+        const int states[3][3] = {{SM, LM, IM}, {SL, LL, IL}, {SU, LU, IU}};
+        for (int k = 0; k < 3; k++){
+            int score = prev[states[k][0]][j];
+            int length = prev[states[k][1]][j];
+            int matches = prev[states[k][2]][j];
+            if (score > alignmentScore || (score == alignmentScore
+                    && (long) matches * alignmentLength > (long) totalMatches * length)){
+                alignmentScore = score;
+                alignmentLength = length;
+                totalMatches = matches;
+            }
+        }
+    }
+}
+
+int WrapAlignE::getScore(){
+    return alignmentScore;
+}
+
+int WrapAlignE::getLength(){
+    return alignmentLength;
+}
+
+double WrapAlignE::getIdentity(){
+    if (!isExact){
+        return identityBound;
+    }
+    if (alignmentLength == 0){
+        return 0.0;
+    }
+    return (double) totalMatches / alignmentLength;
+}
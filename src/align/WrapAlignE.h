@@ -0,0 +1,53 @@
+/**
+ * Bioinformatics Toolsmith Laboratory, University of Tulsa
+ *
+ * Wraparound alignment of a region against the endless repeat of a motif,
+ * (motif)(motif)(motif)..., after Fischetti et al. (1993). The region is
+ * aligned end to end; the repeat may start and stop at any position of
+ * the motif. Scoring matches GlobAlignE: affine gaps, with the score,
+ * length and identical pairs tracked for each of the three states.
+ *
+ * Only two rows of |motif| cells are kept, so a region of length n costs
+ * O(n * |motif|) time and O(|motif|) memory.
+ **/
+
+#ifndef WRAP_ALIGNE_H_
+#define WRAP_ALIGNE_H_
+#include <string>
+
+using namespace std;
+
+namespace utility{
+
+class WrapAlignE{
+
+private:
+    const char * seq; //region to be aligned
+    int start;
+    int end;
+    string motif;
+    int match; //score for base pair match
+    int mismatch;//score for base pair mismatch
+    int gapOpen; //cost to open a gap
+    int gapContinue; //cost to continue a gap
+    int alignmentScore;
+    int alignmentLength;
+    int totalMatches;
+    bool isExact; //false when only a bound below the cutoff is known
+    double identityBound;
+
+    void findAlignment(double);
+
+public:
+    /**
+     * With a cutoff in (0, 1], the alignment stops as soon as its identity
+     * is certain to fall below the cutoff; getIdentity then returns an
+     * upper bound that is below the cutoff.
+     */
+    WrapAlignE(const char*,int,int,const string&, int,int,int,int, double = -1.0);
+    double getIdentity();
+    int getLength();
+    int getScore();
+};
+}
+#endif
@@ -9,6 +9,7 @@
 #include <cstring>
 #include <cfenv>
 #include <iostream>
+#include <algorithm>
 
 
 template<class T>
@@ -81,13 +82,42 @@ double DivergencePoint<T>::distance_k1(const Point<T> &p) const
 	return (double)dist / (double)mag;
 
 }
+/*
+ * Count vectors of destroyed points are kept in a small per-thread pool and
+ * handed to the next point of the same size, so scoring many candidate
+ * profiles does not go back to the allocator for every point.
+ */
+#define DIVERGENCE_POOL_SIZE 32
+
+template<class T>
+static std::vector<std::vector<T> >& count_pool()
+{
+	static thread_local std::vector<std::vector<T> > pool;
+	return pool;
+}
+
+template<class T>
+static void acquire_counts(std::vector<T>& out, size_t size)
+{
+	auto& pool = count_pool<T>();
+	while (!pool.empty()) {
+		out.swap(pool.back());
+		pool.pop_back();
+		if (out.capacity() >= size) {
+			break;
+		}
+	}
+	out.resize(size);
+}
+
 template<class T>
 DivergencePoint<T>::DivergencePoint(const std::vector<T>& pts, uint64_t len)
 {
+	acquire_counts(points, pts.size());
 	mag = 0;
 	for (unsigned int i = 0; i < pts.size(); i++) {
-		points.push_back(pts.at(i));
-		mag += pts.at(i);
+		points[i] = pts[i];
+		mag += pts[i];
 	}
 
 	nucl_length = len;
@@ -99,14 +129,23 @@ DivergencePoint<T>::DivergencePoint(const std::vector<T>& pts, uint64_t len)
 template<class T>
 DivergencePoint<T>::DivergencePoint(unsigned int size)
 {
-	for (unsigned int i = 0; i < size; i++) {
-		points.push_back(0);
-	}
+	acquire_counts(points, size);
+	std::fill(points.begin(), points.end(), 0);
 	to_delete = false;
 	nucl_length = 0;
 	id = 0;
 }
 
+template<class T>
+DivergencePoint<T>::~DivergencePoint()
+{
+	auto& pool = count_pool<T>();
+	if (pool.size() < DIVERGENCE_POOL_SIZE && points.capacity() > 0) {
+		pool.emplace_back();
+		pool.back().swap(points);
+	}
+}
+
 template<class T>
 void DivergencePoint<T>::operator*=(double d)
 {
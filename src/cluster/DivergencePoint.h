@@ -14,7 +14,7 @@ class DivergencePoint : public Point<T> {
 public:
 	DivergencePoint(const std::vector<T>& pts, uint64_t len);
 	DivergencePoint(unsigned int size);
-	~DivergencePoint() {}
+	~DivergencePoint();
 	void operator*=(double d);
 	void operator/=(double d);
 	uint64_t operator-(const Point<T>& p) const;
@@ -37,6 +37,7 @@ public:
 		d->set_id(get_id());
 		d->set_length(get_length());
 		d->set_stddev(get_stddev());
+		d->set_1mers(Point<T>::get_1mers());
 		return d;
 	}
 	DivergencePoint* create() const {
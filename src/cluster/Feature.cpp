@@ -146,7 +146,47 @@ template<class T>
 vector<double> Feature<T>::compute_all_raw(Point<T> &p, Point<T> &q)
 {
 	vector<double> cache(lookup.size());
+	compute_all_raw(p, q, cache.data());
+	return cache;
+}
+
+template<class T>
+void Feature<T>::compute_all_raw(Point<T> &p, Point<T> &q, double *cache,
+	const fused_side *pside)
+{
 	uint64_t done = 0;
+
+	uint64_t fused = flags & FEAT_FUSED;
+	if (do_save && fused) {
+		for (size_t i = 0; i < lookup.size(); i++) {
+			if ((lookup[i] & fused) == 0) {
+				continue;
+			}
+			auto tup = std::tuple<uintmax_t, uintmax_t, uint8_t>(p.get_id(), q.get_id(), Feature<T>::log2(lookup[i]));
+			auto res = ltable.find(tup);
+			if (res != ltable.end()) {
+				cache[i] = res->second;
+				fused &= ~lookup[i];
+				done |= lookup[i];
+			}
+		}
+	}
+	if (fused) {
+		double raw[64];
+		fused_raw(p, q, fused, raw, pside);
+		for (size_t i = 0; i < lookup.size(); i++) {
+			if ((lookup[i] & fused) == 0) {
+				continue;
+			}
+			int idx = Feature<T>::log2(lookup[i]);
+			cache[i] = raw[idx];
+			if (do_save) {
+				auto tup = std::tuple<uintmax_t, uintmax_t, uint8_t>(p.get_id(), q.get_id(), idx);
+				ltable.insert({tup, raw[idx]});
+			}
+		}
+		done |= fused;
+	}
 #ifdef FEATURE_OMP
 #pragma omp parallel for
 #endif
@@ -156,7 +196,105 @@ vector<double> Feature<T>::compute_all_raw(Point<T> &p, Point<T> &q)
 			cache[i] = rres;
 		}
 	}
-	return cache;
+}
+
+/*
+ * Computes the raw values of the FEAT_FUSED features named in "which" with
+ * one pass over the two k-mer vectors. Each accumulator repeats the
+ * arithmetic of the matching stand-alone function in the same order, so
+ * the results are identical to calling them one by one. raw is indexed by
+ * log2 of the feature flag. If pside is given, the terms that depend only
+ * on p are taken from it instead of being accumulated again.
+ */
+template<class T>
+typename Feature<T>::fused_side Feature<T>::fused_prepare(Point<T>& a)
+{
+	const DivergencePoint<T>& p = dynamic_cast<const DivergencePoint<T>&>(a);
+	const auto N = p.points.size();
+	fused_side side;
+	side.mag = p.getPseudoMagnitude();
+	side.mean = (double)side.mag / N;
+	side.sq_sum = 0;
+	side.dev_sum = 0;
+	for (auto i = 0; i < N; i++) {
+		const T pv = p.points[i];
+		side.sq_sum += pv * pv;
+		double dp = pv - side.mean;
+		side.dev_sum += dp * dp;
+	}
+	return side;
+}
+
+template<class T>
+void Feature<T>::fused_raw(Point<T>& a, Point<T>& b, uint64_t which, double *raw,
+	const fused_side *pside)
+{
+	const DivergencePoint<T>& p = dynamic_cast<const DivergencePoint<T>&>(a);
+	const DivergencePoint<T>& q = dynamic_cast<const DivergencePoint<T>&>(b);
+	const auto N = p.points.size();
+	const T *pp = p.points.data();
+	const T *qp = q.points.data();
+	const bool need_p = (pside == NULL);
+	const uintmax_t pmag = need_p ? p.getPseudoMagnitude() : pside->mag;
+	const uintmax_t qmag = q.getPseudoMagnitude();
+
+	uintmax_t euc_sum = 0;
+	int man_sum = 0;
+	uintmax_t inter_dist = 0;
+	uint64_t min_sum = 0;
+	uintmax_t dot = 0, norm2 = 0;
+	uintmax_t d1 = 0, d2 = 0;
+	uintmax_t cp = 0, cq = 0, emd_dist = 0;
+	const double dap = need_p ? (double)pmag / N : pside->mean;
+	const double daq = (double)qmag / N;
+	double pdot = 0, np = 0, nq = 0;
+	for (auto i = 0; i < N; i++) {
+		const T pv = pp[i];
+		const T qv = qp[i];
+		auto diff = pv - qv;
+		euc_sum += diff * diff;
+		man_sum += pv > qv ? pv - qv : qv - pv;
+		inter_dist += 2 * std::min(pv, qv);
+		min_sum += std::min(pv, qv);
+		intmax_t sdiff = pv - qv;
+		dot += pv * qv;
+		norm2 += sdiff * sdiff;
+		if (need_p) {
+			d1 += pv * pv;
+		}
+		d2 += qv * qv;
+		cp += pv;
+		cq += qv;
+		emd_dist += cp > cq ? cp - cq : cq - cp;
+		double dp = pv - dap;
+		double dq = qv - daq;
+		if (need_p) {
+			np += dp * dp;
+		}
+		nq += dq * dq;
+		pdot += dp * dq;
+	}
+	if (!need_p) {
+		d1 = pside->sq_sum;
+		np = pside->dev_sum;
+	}
+
+	if (which & FEAT_KULCZYNSKI2) {
+		double ap = (double)pmag / N;
+		double aq = (double)qmag / N;
+		double coeff = N * (ap + aq) / (2 * ap * aq);
+		raw[Feature<T>::log2(FEAT_KULCZYNSKI2)] = coeff * min_sum;
+	}
+	if (which & FEAT_LENGTHD) {
+		raw[Feature<T>::log2(FEAT_LENGTHD)] = length_difference(a, b);
+	}
+	raw[Feature<T>::log2(FEAT_EUCLIDEAN)] = sqrt(euc_sum);
+	raw[Feature<T>::log2(FEAT_MANHATTAN)] = man_sum;
+	raw[Feature<T>::log2(FEAT_INTERSECTION)] = (double)inter_dist / (double)(pmag + qmag);
+	raw[Feature<T>::log2(FEAT_SIMRATIO)] = dot / (dot + sqrt(norm2));
+	raw[Feature<T>::log2(FEAT_NORMALIZED_VECTORS)] = (double)dot / sqrt(d1 * d2);
+	raw[Feature<T>::log2(FEAT_EMD)] = (double)emd_dist;
+	raw[Feature<T>::log2(FEAT_PEARSON_COEFF)] = pdot / sqrt(np * nq);
 }
 
 template<class T>
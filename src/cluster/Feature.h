@@ -49,6 +49,12 @@
 #define	FEAT_N2RC                (1UL << 32)
 #define	FEAT_N2RRC               (1UL << 33)
 
+/*
+ * Raw features that compute_all_raw evaluates together in a single sweep
+ * over both k-mer vectors instead of one pass per feature
+ */
+#define FEAT_FUSED (FEAT_EUCLIDEAN | FEAT_MANHATTAN | FEAT_INTERSECTION | FEAT_KULCZYNSKI2 | FEAT_SIMRATIO | FEAT_NORMALIZED_VECTORS | FEAT_PEARSON_COEFF | FEAT_EMD | FEAT_LENGTHD)
+
 enum class Combo {
 	xy,
 	x2y2,
@@ -184,6 +190,25 @@ public:
 		}
 	}
 	size_t size() const { return combos.size(); }
+	size_t raw_size() const { return lookup.size(); }
+	/*
+	 * Terms of the fused features that depend only on one point, so that
+	 * one point can be compared against many without recomputing them
+	 */
+	struct fused_side {
+		uintmax_t mag;
+		double mean;
+		uintmax_t sq_sum;
+		double dev_sum;
+	};
+	static fused_side fused_prepare(Point<T>& p);
+	/*
+	 * Writes the raw (unnormalized) value of every single feature into
+	 * cache, in lookup order, without allocating. pside, if given, must
+	 * come from fused_prepare(p).
+	 */
+	void compute_all_raw(Point<T>& p, Point<T>& q, double *cache,
+		const fused_side *pside = NULL);
 	void print_bounds() const {
 		for (size_t i = 0; i < lookup.size(); i++) {
 			cout << "bounds[" << i << "]: " << mins[i] << " to " << maxs[i] << endl;
@@ -281,6 +306,8 @@ public:
 private:
 
 	vector<double> compute_all_raw(Point<T>& p, Point<T>& q);
+	static void fused_raw(Point<T>& p, Point<T>& q, uint64_t which, double *raw,
+		const fused_side *pside = NULL);
 	void normalize_cache(vector<double>& cache) const;
 	int index_of(uint64_t single_flag) const {
 		for (size_t i = 0; i < lookup.size(); i++) {
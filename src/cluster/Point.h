@@ -19,6 +19,7 @@
 template<class T>
 class Point {
 public:
+	Point() : one_mers(), data(NULL) { };
 	virtual ~Point() { };
 	virtual void operator*=(double d) = 0;
 	virtual void operator/=(double d) = 0;
@@ -49,8 +50,16 @@ public:
 	void set_header(const std::string c) { header = string(c); };
 	const std::string get_header() const { return header; };
 
-	void set_data_str(const std::string c) { data = c; };
-	const std::string & get_data_str() const { return data; };
+	/*
+	 * The sequence is not copied: the point only refers to it, so the
+	 * owner (usually the chromosome the point was built from) must outlive
+	 * every alignment that uses it. Clones do not carry the sequence.
+	 */
+	void set_data_str(const std::string &c) { data = &c; };
+	const std::string & get_data_str() const {
+		static const std::string empty;
+		return data == NULL ? empty : *data;
+	};
 
 	void set_1mers(const vector<uint64_t> &vec) {
 		for (auto i = 0; i < 4; i++) {
@@ -72,7 +81,7 @@ public:
 private:
 	uint64_t one_mers[4];
 	std::string header;
-	std::string data;
+	const std::string *data;
 };
 
 #endif
@@ -4,12 +4,19 @@
 #include <cmath>
 #include "Progress.h"
 #include "../align/GlobAlignE.h"
+#include "../align/EditAlignE.h"
 #include <random>
+#include <atomic>
 
 
 
 std::default_random_engine generatorSelector (0);  // minstd_rand0 is a standard linear_congruential_engine
 
+// How many cutoff alignments were asked for, and how many of them the edit
+// distance bound decided without an affine alignment
+std::atomic<long> cutoffAlignCount(0);
+std::atomic<long> cutoffFastCount(0);
+
 
 template<class T>
 void Selector<T>::select(double cutoff)
@@ -47,6 +54,8 @@ vector<pair<Point<T>*, Point<T>*> > Selector<T>::split(double cutoff)
 		(a.first->get_header() == b.first->get_header() && a.second->get_header().compare(b.second->get_header()) < 0);
 	};
 	set<pair<Point<T>*, Point<T>*>, decltype(cmp)> pairs(cmp);
+	cutoffAlignCount = 0;
+	cutoffFastCount = 0;
 
 	const size_t total_num_pairs = sample_size * 2;
 	int aerr = 0;
@@ -83,7 +92,7 @@ vector<pair<Point<T>*, Point<T>*> > Selector<T>::split(double cutoff)
 		double closest_algn = 20000;
 		size_t best_pivot = 2 * offset;
 		for (pivot = 2 * offset; offset > 0; offset /= 2) {
-			double algn = align(p, pts[pivot]);
+			double algn = align(p, pts[pivot], cutoff);
 			if (fabs(algn - cutoff) < closest_algn) {
 				closest_algn = fabs(algn - cutoff);
 				best_pivot = pivot;
@@ -136,6 +145,8 @@ vector<pair<Point<T>*, Point<T>*> > Selector<T>::split(double cutoff)
 		}
 	}
 	prog.end();
+	cout << "Edit distance decided " << cutoffFastCount << " of "
+	     << cutoffAlignCount << " alignments" << endl;
 	if (aerr < 0) {
 		cerr << "Warning: Alignment may be too small for sampling" << endl;
 	} else if (aerr > 0) {
@@ -167,6 +178,35 @@ double Selector<T>::align(Point<T> *a, Point<T>* b)
 
 }
 
+/*
+ * Only which side of cutoff the identity falls on is exact: below the
+ * cutoff, the returned value may be an upper bound that is still below it.
+ * The bit-parallel edit distance bounds the identity first, so the affine
+ * alignment only runs on pairs that may reach the cutoff.
+ */
+template<class T>
+double Selector<T>::align(Point<T> *a, Point<T>* b, double cutoff)
+{
+	auto sa = a->get_data_str();
+	auto sb = b->get_data_str();
+	int la = sa.length();
+	int lb = sb.length();
+
+	cutoffAlignCount++;
+	EditAlignE ealign(sa.c_str(), 0, la-1, sb.c_str(), 0, lb-1);
+	double bound = ealign.getIdentityBound();
+	if (bound < cutoff) {
+		cutoffFastCount++;
+		return bound;
+	}
+
+	GlobAlignE galign(sa.c_str(), 0, la-1,
+		sb.c_str(), 0, lb-1,
+		1, -1, 2, 1, cutoff);
+
+	return galign.getIdentity();
+}
+
 template<class T>
 vector<pra<T> > resize_vec(vector<pra<T> > &vec, size_t new_size)
 {
@@ -30,6 +30,7 @@ public:
 			vector<pra<T> > > &tr) { testing = tr; }
 	void select(double cutoff);
 	static double align(Point<T>*a, Point<T>*b);
+	static double align(Point<T>*a, Point<T>*b, double cutoff);
 	pair<vector<pra<T> >,
 	vector<pra<T> > > get_training() const { return training; }
 	pair<vector<pra<T> >,
@@ -15,9 +15,57 @@ using namespace std;
 
 namespace matrix {
 
+/**
+ * Least squares weights from the normal equations X'X w = X'y, solved by a
+ * Cholesky decomposition instead of inverting X'X. If some features are
+ * (nearly) combinations of others, X'X is too ill-conditioned for that, and
+ * the weights come from a QR decomposition of X itself.
+ */
 void GLM::train(Matrix& features, Matrix& labels) {
-	weights = features.transpose() * features;
-	weights = weights.pseudoInverse() * features.transpose() * labels;
+	Matrix gram = features.transposeTimes(features);
+	moment = features.transposeTimes(labels);
+	if (gram.choleskyFactor(factor)) {
+		weights = factor.choleskySubstitute(moment);
+	} else {
+		factor = Matrix();
+		weights = features.qrSolve(labels);
+	}
+}
+
+/**
+ * Trains on features whose columns are the ones base was trained on plus
+ * one more at the end, as forward selection does for each candidate. The
+ * factor of base is bordered by the new column in O(p^2) instead of
+ * forming and factoring X'X again, and gives the same weights the full
+ * train would. Falls back to the full train if base has no factor or the
+ * new column is (nearly) a combination of the others.
+ */
+void GLM::train(const GLM& base, Matrix& features, Matrix& labels) {
+	const int p = base.factor.getNumRow();
+	const int n = features.getNumRow();
+	if (p == 0 || features.getNumCol() != p + 1
+		|| base.moment.getNumCol() != labels.getNumCol()) {
+		train(features, labels);
+		return;
+	}
+	Matrix column(n, 1);
+	for (int row = 0; row < n; row++) {
+		column.set(row, 0, features.get(row, p));
+	}
+	Matrix border = features.transposeTimes(column);
+	if (!base.factor.choleskyBorder(border, factor)) {
+		train(features, labels);
+		return;
+	}
+	Matrix last = column.transposeTimes(labels);
+	moment = Matrix(p + 1, labels.getNumCol());
+	for (int c = 0; c < labels.getNumCol(); c++) {
+		for (int i = 0; i < p; i++) {
+			moment.set(i, c, base.moment.get(i, c));
+		}
+		moment.set(p, c, last.get(0, c));
+	}
+	weights = factor.choleskySubstitute(moment);
 }
 
 Matrix GLM::predict(Matrix& features) const {
@@ -18,9 +18,14 @@ namespace matrix {
 class GLM {
 private:
 	Matrix weights;
+	// Kept from training to extend the model by a feature: the Cholesky
+	// factor of X'X, empty if X'X had none, and X'y
+	Matrix factor;
+	Matrix moment;
 
 public:
 	void train(matrix::Matrix& features, matrix::Matrix& labels);
+	void train(const GLM& base, matrix::Matrix& features, matrix::Matrix& labels);
 	Matrix predict(matrix::Matrix& features) const;
 	tuple<double, double, double> accuracy(matrix::Matrix& oLabels, matrix::Matrix& pLabels) const;
     const Matrix& get_weights() const { return weights; };
@@ -15,34 +15,30 @@
 #include <iomanip>
 #include <stdlib.h>
 #include <math.h>
+#include <algorithm>
+#include <stdexcept>
 
 using namespace std;
 
 namespace matrix {
 
+// The smallest part of a diagonal cell a Cholesky factor may leave after
+// taking out the columns before it
+static const double CHOLESKY_TOLERANCE = 1e-10;
+
 Matrix::Matrix(int r, int c) :
-				numRow(r), numCol(c) {
-	m.resize(r);
-	for (int i = 0; i < r; i++) {
-		m.at(i) = vector<double>(c);
-	}
+				m((size_t) r * c), numRow(r), numCol(c) {
 }
 Matrix::Matrix() :
 				numRow(0), numCol(0) {
 
 }
 
-Matrix::~Matrix() {
-
-}
-
-Matrix Matrix::operator+(Matrix n) {
+Matrix Matrix::operator+(const Matrix& n) const {
 	if (numCol == n.numCol && numRow == n.numRow) {
 		Matrix mat = Matrix(numRow, numCol);
-		for (int i = 0; i < mat.numRow; i++) {
-			for (int j = 0; j < mat.numCol; j++) {
-				mat.set(i, j, (get(i, j) + n.get(i, j)));
-			}
+		for (size_t i = 0; i < m.size(); i++) {
+			mat.m[i] = m[i] + n.m[i];
 		}
 		return mat;
 	} else {
@@ -51,13 +47,11 @@ Matrix Matrix::operator+(Matrix n) {
 	}
 }
 
-Matrix Matrix::operator-(Matrix n) {
+Matrix Matrix::operator-(const Matrix& n) const {
 	if (numCol == n.numCol && numRow == n.numRow) {
 		Matrix mat = Matrix(numRow, numCol);
-		for (int i = 0; i < mat.numRow; i++) {
-			for (int j = 0; j < mat.numCol; j++) {
-				mat.set(i, j, (get(i, j) - n.get(i, j)));
-			}
+		for (size_t i = 0; i < m.size(); i++) {
+			mat.m[i] = m[i] - n.m[i];
 		}
 		return mat;
 	} else {
@@ -66,18 +60,35 @@ Matrix Matrix::operator-(Matrix n) {
 	}
 }
 
-Matrix Matrix::operator*(Matrix n) {
+/**
+ * The product is accumulated in blocks of the inner dimension and of the
+ * columns, so the rows of n being read stay in cache. The innermost loop
+ * runs along contiguous rows of n and of the result, which the compiler
+ * turns into SIMD code. Each cell still sums its terms in order.
+ */
+Matrix Matrix::operator*(const Matrix& n) const {
 
 	if (numCol == n.numRow) {
-		double curSum = 0;
+		const int block = 64;
 		Matrix mat = Matrix(numRow, n.numCol);
-		for (int i = 0; i < mat.numRow; i++) {
-			for (int j = 0; j < mat.numCol; j++) {
-				curSum = 0;
-				for (int k = 0; k < numCol; k++) {
-					curSum = curSum + get(i, k) * n.get(k, j);
+		const double * a = m.data();
+		const double * b = n.m.data();
+		double * c = mat.m.data();
+		for (int kk = 0; kk < numCol; kk += block) {
+			int kEnd = min(kk + block, numCol);
+			for (int jj = 0; jj < n.numCol; jj += block) {
+				int jEnd = min(jj + block, n.numCol);
+				for (int i = 0; i < numRow; i++) {
+					const double * aRow = a + (size_t) i * numCol;
+					double * cRow = c + (size_t) i * n.numCol;
+					for (int k = kk; k < kEnd; k++) {
+						const double aik = aRow[k];
+						const double * bRow = b + (size_t) k * n.numCol;
+						for (int j = jj; j < jEnd; j++) {
+							cRow[j] += aik * bRow[j];
+						}
+					}
 				}
-				mat.set(i, j, curSum);
 			}
 		}
 		return mat;
@@ -87,17 +98,43 @@ Matrix Matrix::operator*(Matrix n) {
 	}
 }
 
-Matrix Matrix::transpose() {
+Matrix Matrix::transpose() const {
 	Matrix temp = Matrix(numCol, numRow);
 	for (int i = 0; i < numRow; i++) {
 		for (int j = 0; j < numCol; j++) {
-			temp.set(j, i, get(i, j));
+			temp.m[(size_t) j * numRow + i] = m[(size_t) i * numCol + j];
 		}
 	}
 	return temp;
 
 }
 
+/**
+ * The transpose of this matrix times n, without forming the transpose.
+ * Both matrices are read a row at a time.
+ */
+Matrix Matrix::transposeTimes(const Matrix& n) const {
+	if (numRow == n.numRow) {
+		Matrix mat = Matrix(numCol, n.numCol);
+		double * c = mat.m.data();
+		for (int r = 0; r < numRow; r++) {
+			const double * aRow = m.data() + (size_t) r * numCol;
+			const double * bRow = n.m.data() + (size_t) r * n.numCol;
+			for (int i = 0; i < numCol; i++) {
+				const double ari = aRow[i];
+				double * cRow = c + (size_t) i * n.numCol;
+				for (int j = 0; j < n.numCol; j++) {
+					cRow[j] += ari * bRow[j];
+				}
+			}
+		}
+		return mat;
+	} else {
+		cerr << "Invalid input: array dimension mismatch." << endl;
+		throw exception();
+	}
+}
+
 Matrix Matrix::gaussJordanInverse() {
 	if (numRow == numCol) {			//Checks if matrix is square
 		Matrix invert = Matrix(numRow, numCol);
@@ -208,12 +245,252 @@ Matrix Matrix::pseudoInverse() {
 	}
 }
 
+/**
+ * The lower triangular L with L L' equal to this symmetric matrix. Returns
+ * false if the matrix is not positive definite or a column is nearly a
+ * combination of the ones before it.
+ */
+bool Matrix::choleskyFactor(Matrix& l) const {
+	if (numRow != numCol) {
+		cerr << "Invalid dimensions" << endl;
+		throw exception();
+	}
+	const int n = numRow;
+	Matrix f(n, n);
+	for (int j = 0; j < n; j++) {
+		const double * lj = &f.m[(size_t) j * n];
+		double d = m[(size_t) j * n + j];
+		for (int k = 0; k < j; k++) {
+			d -= lj[k] * lj[k];
+		}
+		if (!(d > 0) || d <= CHOLESKY_TOLERANCE * m[(size_t) j * n + j]) {
+			return false;
+		}
+		double pivot = sqrt(d);
+		f.m[(size_t) j * n + j] = pivot;
+		for (int i = j + 1; i < n; i++) {
+			double * li = &f.m[(size_t) i * n];
+			double sum = m[(size_t) i * n + j];
+			for (int k = 0; k < j; k++) {
+				sum -= li[k] * lj[k];
+			}
+			li[j] = sum / pivot;
+		}
+	}
+	l = std::move(f);
+	return true;
+}
+
+/**
+ * This is the Cholesky factor of an n by n matrix A, and border holds the
+ * n + 1 cells of a new last column of A, the diagonal cell last. Finds the
+ * factor of the bordered matrix in O(n^2); it is the one choleskyFactor
+ * finds for that matrix, down to the rounding.
+ */
+bool Matrix::choleskyBorder(const Matrix& border, Matrix& l) const {
+	const int n = numRow;
+	if (numCol != n || border.numRow != n + 1 || border.numCol != 1) {
+		cerr << "Invalid dimensions" << endl;
+		throw exception();
+	}
+	Matrix f(n + 1, n + 1);
+	for (int i = 0; i < n; i++) {
+		std::copy(&m[(size_t) i * n], &m[(size_t) i * n] + i + 1,
+				&f.m[(size_t) i * (n + 1)]);
+	}
+	double * last = &f.m[(size_t) n * (n + 1)];
+	for (int j = 0; j < n; j++) {
+		const double * lj = &m[(size_t) j * n];
+		double sum = border.m[j];
+		for (int k = 0; k < j; k++) {
+			sum -= last[k] * lj[k];
+		}
+		last[j] = sum / lj[j];
+	}
+	double d = border.m[n];
+	for (int k = 0; k < n; k++) {
+		d -= last[k] * last[k];
+	}
+	if (!(d > 0) || d <= CHOLESKY_TOLERANCE * border.m[n]) {
+		return false;
+	}
+	last[n] = sqrt(d);
+	l = std::move(f);
+	return true;
+}
+
+/**
+ * Solves L L' x = b, where this is the Cholesky factor L
+ */
+Matrix Matrix::choleskySubstitute(const Matrix& b) const {
+	if (numRow != numCol || b.numRow != numRow) {
+		cerr << "Invalid dimensions" << endl;
+		throw exception();
+	}
+	const int n = numRow;
+	// L z = b, then L' x = z
+	Matrix sol = b;
+	const int rhs = b.numCol;
+	for (int c = 0; c < rhs; c++) {
+		for (int i = 0; i < n; i++) {
+			double sum = sol.m[(size_t) i * rhs + c];
+			for (int k = 0; k < i; k++) {
+				sum -= m[(size_t) i * n + k] * sol.m[(size_t) k * rhs + c];
+			}
+			sol.m[(size_t) i * rhs + c] = sum / m[(size_t) i * n + i];
+		}
+		for (int i = n - 1; i >= 0; i--) {
+			double sum = sol.m[(size_t) i * rhs + c];
+			for (int k = i + 1; k < n; k++) {
+				sum -= m[(size_t) k * n + i] * sol.m[(size_t) k * rhs + c];
+			}
+			sol.m[(size_t) i * rhs + c] = sum / m[(size_t) i * n + i];
+		}
+	}
+	return sol;
+}
+
+/**
+ * Solves this * x = b for a symmetric matrix with a Cholesky decomposition.
+ * Returns false, leaving x alone, if the matrix is not positive definite or
+ * a column is nearly a combination of the ones before it.
+ */
+bool Matrix::choleskySolve(const Matrix& b, Matrix& x) const {
+	if (numRow != numCol || b.numRow != numRow) {
+		cerr << "Invalid dimensions" << endl;
+		throw exception();
+	}
+	Matrix l;
+	if (!choleskyFactor(l)) {
+		return false;
+	}
+	x = l.choleskySubstitute(b);
+	return true;
+}
+
+/**
+ * The least squares solution of this * x = b by Householder QR with column
+ * pivoting. Columns that add nothing beyond the ones already taken get a
+ * weight of zero, so the solution exists even for a rank deficient matrix.
+ */
+Matrix Matrix::qrSolve(const Matrix& b) const {
+	if (b.numRow != numRow) {
+		cerr << "Invalid dimensions" << endl;
+		throw exception();
+	}
+	// Columns whose remaining norm falls below this part of the first
+	// column's norm are left out
+	const double tolerance = 1e-10;
+	const int rows = numRow;
+	const int cols = numCol;
+	const int rhs = b.numCol;
+
+	Matrix r = *this;
+	Matrix y = b;
+	vector<int> perm(cols);
+	for (int j = 0; j < cols; j++) {
+		perm[j] = j;
+	}
+	vector<double> diag(cols);
+	vector<double> norm(cols);
+
+	int rank = 0;
+	double first = 0;
+	for (int k = 0; k < min(rows, cols); k++) {
+		// Take the column with the largest norm below row k
+		for (int j = k; j < cols; j++) {
+			norm[j] = 0;
+		}
+		for (int i = k; i < rows; i++) {
+			const double * row = &r.m[(size_t) i * cols];
+			for (int j = k; j < cols; j++) {
+				norm[j] += row[j] * row[j];
+			}
+		}
+		int pivot = k;
+		for (int j = k + 1; j < cols; j++) {
+			if (norm[j] > norm[pivot]) {
+				pivot = j;
+			}
+		}
+		if (pivot != k) {
+			for (int i = 0; i < rows; i++) {
+				swap(r.m[(size_t) i * cols + k], r.m[(size_t) i * cols + pivot]);
+			}
+			swap(norm[k], norm[pivot]);
+			swap(perm[k], perm[pivot]);
+		}
+
+		double alpha = sqrt(norm[k]);
+		if (k == 0) {
+			first = alpha;
+		}
+		if (alpha == 0 || alpha <= tolerance * first) {
+			break;
+		}
+		double x0 = r.m[(size_t) k * cols + k];
+		if (x0 > 0) {
+			alpha = -alpha;
+		}
+		// The reflector is v = x - alpha e1, kept in column k from row k on
+		double v0 = x0 - alpha;
+		r.m[(size_t) k * cols + k] = v0;
+		double beta = -1 / (alpha * v0);
+
+		for (int j = k + 1; j < cols; j++) {
+			double s = 0;
+			for (int i = k; i < rows; i++) {
+				s += r.m[(size_t) i * cols + k] * r.m[(size_t) i * cols + j];
+			}
+			s *= beta;
+			for (int i = k; i < rows; i++) {
+				r.m[(size_t) i * cols + j] -= s * r.m[(size_t) i * cols + k];
+			}
+		}
+		for (int j = 0; j < rhs; j++) {
+			double s = 0;
+			for (int i = k; i < rows; i++) {
+				s += r.m[(size_t) i * cols + k] * y.m[(size_t) i * rhs + j];
+			}
+			s *= beta;
+			for (int i = k; i < rows; i++) {
+				y.m[(size_t) i * rhs + j] -= s * r.m[(size_t) i * cols + k];
+			}
+		}
+		diag[k] = alpha;
+		rank = k + 1;
+	}
+
+	// Back substitution on the leading rank x rank block of R
+	Matrix x(cols, rhs);
+	for (int j = 0; j < rhs; j++) {
+		vector<double> sol(rank);
+		for (int i = rank - 1; i >= 0; i--) {
+			double sum = y.m[(size_t) i * rhs + j];
+			for (int k = i + 1; k < rank; k++) {
+				sum -= r.m[(size_t) i * cols + k] * sol[k];
+			}
+			sol[i] = sum / diag[i];
+		}
+		for (int i = 0; i < rank; i++) {
+			x.m[(size_t) perm[i] * rhs + j] = sol[i];
+		}
+	}
+	return x;
+}
+
 double Matrix::get(int r, int c) const {
-	return m.at(r).at(c);
+	if (r < 0 || r >= numRow || c < 0 || c >= numCol) {
+		throw out_of_range("Matrix::get");
+	}
+	return m[(size_t) r * numCol + c];
 }
 
 void Matrix::set(int r, int c, double val) {
-	m.at(r).at(c) = val;
+	if (r < 0 || r >= numRow || c < 0 || c >= numCol) {
+		throw out_of_range("Matrix::set");
+	}
+	m[(size_t) r * numCol + c] = val;
 }
 
 void Matrix::print() {
@@ -295,15 +572,17 @@ void Matrix::fileFill(string filename) {
 
 void Matrix::addRow(double val) {
 	numRow++;
-	vector<double> temp = vector<double>(numCol, val);
-	m.push_back(temp);
+	m.resize((size_t) numRow * numCol, val);
 }
 
 void Matrix::addCol(double val) {
-	numCol++;
+	vector<double> temp((size_t) numRow * (numCol + 1), val);
 	for (int i = 0; i < numRow; i++) {
-		m.at(i).push_back(val);
+		copy(m.begin() + (size_t) i * numCol, m.begin() + (size_t) (i + 1) * numCol,
+				temp.begin() + (size_t) i * (numCol + 1));
 	}
+	m.swap(temp);
+	numCol++;
 }
 
 void Matrix::normalize(double a, double b) {
@@ -328,7 +607,7 @@ void Matrix::rowToVector(int row, vector<double>& v) {
 		cerr << "Invalid Row (rowToVector)" << endl;
 		throw exception();
 	} else {
-		v = m.at(row);
+		v.assign(m.begin() + (size_t) row * numCol, m.begin() + (size_t) (row + 1) * numCol);
 	}
 }
 
@@ -338,7 +617,7 @@ void Matrix::colToVector(int col, vector<double>& v) {
 		throw exception();
 	} else {
 		for (int j = 0; j < numRow; j++) {
-			v.push_back(m.at(j).at(col));
+			v.push_back(m[(size_t) j * numCol + col]);
 		}
 	}
 }
@@ -14,10 +14,14 @@
 
 namespace matrix {
 
+/*
+ * The cells are stored row by row in one array, so rows are contiguous and
+ * matrices are copied and moved as a single block.
+ */
 class Matrix
 {
 private:
-	std::vector<std::vector<double> > m;
+	std::vector<double> m;
 	int numRow;
 	int numCol;
 
@@ -26,13 +30,18 @@ public:
 
 	Matrix(int r, int c);
 	Matrix();
-	~Matrix();
-	Matrix operator+(Matrix n);
-	Matrix operator-(Matrix n);
-	Matrix operator*(Matrix n);
-	Matrix transpose();
+	Matrix operator+(const Matrix& n) const;
+	Matrix operator-(const Matrix& n) const;
+	Matrix operator*(const Matrix& n) const;
+	Matrix transpose() const;
+	Matrix transposeTimes(const Matrix& n) const;
 	Matrix gaussJordanInverse();
 	Matrix pseudoInverse();
+	bool choleskyFactor(Matrix& l) const;
+	bool choleskyBorder(const Matrix& border, Matrix& l) const;
+	Matrix choleskySubstitute(const Matrix& b) const;
+	bool choleskySolve(const Matrix& b, Matrix& x) const;
+	Matrix qrSolve(const Matrix& b) const;
 	void userFill();
 	double determinant();
 	double get(int r, int c) const;
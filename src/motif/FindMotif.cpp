@@ -5,10 +5,18 @@ using namespace std;
 
 namespace motif {
 
+	/*
+	 * With isWraparoundIn, the candidates are scored by exact wraparound
+	 * alignment against the sequence and the predictor is not used. With
+	 * periodsIn, e.g. from findPeriods, only words whose length is a
+	 * multiple of one of the periods are candidates.
+	 */
 	FindMotif::FindMotif(string sequenceIn, double thresholdIn,
-		Predictor<int> * predIn) {
+		Predictor<int> * predIn, bool isWraparoundIn, vector<int> periodsIn) {
 		sequence = sequenceIn;
 		threshold = thresholdIn;
+		isWraparound = isWraparoundIn;
+		periods = periodsIn;
 		smoothingWindow = -1;
 		h1 = ">Sequence";
 
@@ -16,10 +24,17 @@ namespace motif {
 		foundMotif = string("");
 		identityScore = -1;
 		pred = predIn;
-		ChromosomeOneDigit seqCode(sequence, h1);
-		seqPoint = pred->get_point(&seqCode);
+		// The point refers to the sequence of seqCode, which must outlive
+		// the search
+		seqPoint = NULL;
+		ChromosomeOneDigit * seqCode = NULL;
+		if (!isWraparound) {
+			seqCode = new ChromosomeOneDigit(sequence, h1);
+			seqPoint = pred->get_point(seqCode);
+		}
 
 		searchMicro();
+		delete seqCode;
 	}
 
 	
@@ -40,6 +55,53 @@ namespace motif {
  	return result;
  }
 
+/*
+ * Ranks the lags 1 to MICRO_MAX_SIZE by how often a base of the one-digit sequence
+ * (codes 0 to 3) at start to start + len - 1 equals the base lag positions
+ * later. Returns the lags matching at least PERIOD_MIN_MATCH of the time,
+ * best first; empty if the region has no clear period.
+ *
+ * The bases are packed two bits each, 32 to a word, so one XOR compares 32
+ * pairs of bases.
+ */
+ vector<int> FindMotif::findPeriods(const string * base, int start, int len) {
+ 	const int words = len / 32 + 2;
+ 	vector<uint64_t> packed(words, 0);
+ 	for (int i = 0; i < len; i++) {
+ 		uint64_t code = base->at(start + i) & 3;
+ 		packed[i / 32] |= code << (2 * (i % 32));
+ 	}
+
+ 	const uint64_t lowBits = 0x5555555555555555ULL;
+ 	vector<pair<double, int> > ranked;
+ 	for (int lag = 1; lag <= MICRO_MAX_SIZE && lag < len; lag++) {
+ 		const int pairs = len - lag;
+ 		const int shift = 2 * lag;
+ 		int mismatches = 0;
+ 		for (int w = 0; 32 * w < pairs; w++) {
+ 			uint64_t later = (packed[w] >> shift) | (packed[w + 1] << (64 - shift));
+ 			uint64_t diff = packed[w] ^ later;
+ 			uint64_t differs = (diff | (diff >> 1)) & lowBits;
+ 			int rest = pairs - 32 * w;
+ 			if (rest < 32) {
+ 				differs &= ((uint64_t) 1 << (2 * rest)) - 1;
+ 			}
+ 			mismatches += __builtin_popcountll(differs);
+ 		}
+ 		double match = (double) (pairs - mismatches) / pairs;
+ 		if (match >= PERIOD_MIN_MATCH) {
+ 			ranked.push_back(make_pair(-match, lag));
+ 		}
+ 	}
+ 	std::sort(ranked.begin(), ranked.end());
+
+ 	vector<int> result;
+ 	for (int i = 0; i < ranked.size(); i++) {
+ 		result.push_back(ranked[i].second);
+ 	}
+ 	return result;
+ }
+
 /*
  * This makes an exact repeat from the word. The repeat will be of size len
  */
@@ -75,7 +137,6 @@ namespace motif {
  */
 
  void FindMotif::greedyConfirmation(vector<string> * copyList) {
- 	static int callCount = 0;
  	if (copyList->empty()) {
  		std::cerr << "The given copyList in the greedyConfirmation is empty!"
  		<< std::endl;
@@ -87,22 +148,35 @@ namespace motif {
  	result.first = string("");
  	result.second = -1;
 
-	// Collects the distances into a list
- 	for (int i = 0; i < copyList->size(); i++, callCount++) {
-
- 		string copy = copyList->at(i);
-
-
-		// Make exact repeat, i.e. (motif)n
- 		string w = makeExact(copy, sequence.size());
-
- 		ChromosomeOneDigit wCode(w, copy);
-
- 		Point<int> * wPoint = pred->get_point(&wCode);
+	// Scores the exact repeats, i.e. (motif)n, in batches against the sequence.
+	// The chromosomes are kept until the batch is scored because the points
+	// refer to their sequences.
+ 	vector<ChromosomeOneDigit *> codes;
+ 	vector<Point<int> *> points;
+ 	vector<size_t> lengths;
+ 	for (int start = 0; start < copyList->size(); start += BATCH_SIZE) {
+ 		int end = min((int) copyList->size(), start + BATCH_SIZE);
+ 		for (int i = start; i < end; i++) {
+ 			string copy = copyList->at(i);
+
+			// Make exact repeat, i.e. (motif)n
+ 			string w = makeExact(copy, sequence.size());
+ 			ChromosomeOneDigit * wCode = new ChromosomeOneDigit(w, copy);
+ 			codes.push_back(wCode);
+ 			points.push_back(pred->get_point(wCode));
+ 			lengths.push_back(copy.size());
+ 		}
 
- 		double similarity = pred->similarity(seqPoint, wPoint);
- 		delete wPoint;
+ 		auto best = pred->best_similarity(seqPoint, points, lengths);
+ 		Util::deleteInVector(&points);
+ 		Util::deleteInVector(&codes);
+ 		lengths.clear();
+ 		if (best.first < 0) {
+ 			continue;
+ 		}
 
+ 		string copy = copyList->at(start + best.first);
+ 		double similarity = best.second;
  		if (fabs(result.second - similarity) < std::numeric_limits<double>::epsilon() && copy.size() < result.first.size()) {
  			result.first = copy;
  			result.second = similarity;
@@ -137,6 +211,84 @@ namespace motif {
 
 
 
+/**
+ * Like greedyConfirmation, but each candidate motif is scored by the exact
+ * identity of the wraparound alignment of the sequence against
+ * (motif)(motif)..., in O(|sequence| * |motif|) time. Ties are broken in
+ * favor of the shorter, then the alphabetically first, motif.
+ *
+ * The repeat may start anywhere in the motif, so all rotations of a word
+ * have the same identity and are aligned once. A word that is a power of a
+ * shorter word, e.g. ACAC, has the identity of that word, which is also a
+ * candidate and wins the tie. The most frequent words are aligned first,
+ * since they are the likely motifs; a word stops being aligned once it can
+ * no longer reach the best identity so far.
+ */
+ void FindMotif::wraparoundConfirmation(vector<string> * copyList,
+ 	map<string, int>& wordSet) {
+ 	// The alphabetically first rotation of each primitive word
+ 	map<string, int> rotationCount;
+ 	vector<string> rotationOf(copyList->size());
+ 	for (int i = 0; i < copyList->size(); i++) {
+ 		const string& copy = copyList->at(i);
+ 		string doubled = copy + copy;
+ 		if (doubled.find(copy, 1) < copy.size()) {
+ 			continue;
+ 		}
+ 		string first = copy;
+ 		for (int r = 1; r < copy.size(); r++) {
+ 			first = min(first, doubled.substr(r, copy.size()));
+ 		}
+ 		rotationOf.at(i) = first;
+ 		rotationCount[first] += wordSet.at(copy);
+ 	}
+
+ 	vector<pair<int, string> > order;
+ 	for (auto it = rotationCount.begin(); it != rotationCount.end(); it++) {
+ 		order.push_back(make_pair(-it->second, it->first));
+ 	}
+ 	std::sort(order.begin(), order.end());
+
+ 	const double epsilon = std::numeric_limits<double>::epsilon();
+ 	map<string, double> rotationIdentity;
+ 	double best = -1;
+ 	for (int i = 0; i < order.size(); i++) {
+ 		const string& rotation = order.at(i).second;
+ 		utility::WrapAlignE walign(sequence.c_str(), 0, sequence.size() - 1, rotation,
+ 			1, -1, 2, 1, best - epsilon);
+ 		double similarity = walign.getIdentity();
+ 		rotationIdentity[rotation] = similarity;
+ 		best = max(best, similarity);
+ 	}
+
+ 	pair<string, double> result;
+ 	result.first = string("");
+ 	result.second = -1;
+ 	for (int i = 0; i < copyList->size(); i++) {
+ 		if (rotationOf.at(i).empty()) {
+ 			continue;
+ 		}
+ 		string copy = copyList->at(i);
+ 		double similarity = rotationIdentity.at(rotationOf.at(i));
+
+ 		if (fabs(result.second - similarity) < epsilon) {
+ 			if (copy.size() < result.first.size()
+ 				|| (copy.size() == result.first.size() && copy < result.first)) {
+ 				result.first = copy;
+ 				result.second = similarity;
+ 			}
+ 		}
+ 		else if (similarity > result.second) {
+ 			result.first = copy;
+ 			result.second = similarity;
+ 		}
+ 	}
+
+ 	foundMotif = result.first;
+ 	identityScore = result.second;
+ 	isFound = result.second > threshold;
+ }
+
 /*
  This method will create a vector of words that were found in the sequence.
  These words will be compared to the sequence.
@@ -148,6 +300,13 @@ namespace motif {
 	vector<string> * wordList = new vector<string>();
 	for (int size = 1; size <= MICRO_MAX_SIZE && size <= sequence.size();
 		size++) {
+		bool isAllowed = periods.empty();
+		for (int i = 0; i < periods.size() && !isAllowed; i++) {
+			isAllowed = size % periods[i] == 0;
+		}
+		if (!isAllowed) {
+			continue;
+		}
 		deque<char> word;
 	for (int i = 0; i < sequence.size(); i++) {
 		word.push_back(sequence.at(i));
@@ -172,7 +331,10 @@ namespace motif {
 		}
 	}
 
-	if (!wordList->empty()) {
+	if (!wordList->empty() && isWraparound) {
+		wraparoundConfirmation(wordList, wordSet);
+		wordList->clear();
+	} else if (!wordList->empty()) {
 		greedyConfirmation(wordList);
 		wordList->clear();
 	} else {
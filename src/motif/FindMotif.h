@@ -6,12 +6,14 @@
 #include <vector>
 #include <algorithm>
 #include <math.h>
+#include <map>
 #include <unordered_map>
 #include <unordered_set>
 #include <deque>
 #include <limits>
 
 #include "../align/GlobAlignE.h"
+#include "../align/WrapAlignE.h"
 #include "../nonltr/ChromosomeOneDigit.h"
 #include "../train/Predictor.h"
 #include "../align/RepeatAlignE.h"
@@ -29,19 +31,27 @@ private:
 	double identityScore;
 	int smoothingWindow;
 	double threshold;
-	const int MICRO_MAX_SIZE = 10;
+	bool isWraparound;
+	vector<int> periods;
+	static const int MICRO_MAX_SIZE = 10;
+	// A lag whose bases match at least this often is taken as a period
+	static constexpr double PERIOD_MIN_MATCH = 0.85;
+	const int BATCH_SIZE = 64;
 	string h1;
 	Predictor<int> * pred;
 	Point<int> * seqPoint;
 
 	string dequeToString(deque<char>&);
 	void greedyConfirmation(vector<string> *);
+	void wraparoundConfirmation(vector<string> *, map<string, int>&);
 	void searchMicro();
 
 public:
-	FindMotif(string, double, Predictor<int> *);
+	FindMotif(string, double, Predictor<int> *, bool = false,
+		vector<int> = vector<int>());
 	virtual ~FindMotif();
 	static string makeExact(string, int);
+	static vector<int> findPeriods(const string *, int, int);
 
 	bool getIsFound();
 	string getFoundMotif();
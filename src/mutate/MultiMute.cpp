@@ -124,36 +124,34 @@ vector<bool> MultiMute::genMulti(string * sequence){
 	alignmentLength = maxInsert + maxDup;
 	IBP = maxDel;
  	//Initialize and size vectors
-	int total = maxNonMutations + (2 * maxReverse) + maxTrans + maxInsert + maxTrans + maxDel + maxDup;
 	insertions = new vector<string>();
 	insertions->reserve(maxTrans + maxInsert);
-	mutationStrings = new vector<string>();
-	mutationStrings->reserve(total);
- 	//Push 'S', which means that that is an index that wont be mutated, onto the vector
-	for(int i = 0; i < maxNonMutations; i++){
-		mutationStrings->push_back("S");
+	mutationRuns = new vector<Run>();
+ 	//Push a run of 'S', which means that those indexes wont be mutated, onto the vector
+	if(maxNonMutations > 0){
+		mutationRuns->push_back(Run('S', maxNonMutations));
 	}
 
-	reverse(mutationStrings);
-	insert(mutationStrings);
-	translocate(mutationStrings);
-	duplicate(mutationStrings);
-	deleteNucl(mutationStrings);
+	reverse(mutationRuns);
+	insert(mutationRuns);
+	translocate(mutationRuns);
+	duplicate(mutationRuns);
+	deleteNucl(mutationRuns);
 
     //Make sure no palindromes exist
-	checkForAllPalindromes(mutationStrings);
- 	//Generate a char vector from the now shuffled mutations vector
-	auto mutationChars = genCharVector(mutationStrings);
+	checkForAllPalindromes(mutationRuns);
+ 	//Generate a char vector from the mutation runs
+	auto mutationChars = genCharVector(mutationRuns);
 	getTranslocations(mutationChars);
  	//Performs all mutations on the sequence
 	auto ret = formatString(seq->length() + maxTrans + maxInsert + maxDup, mutationChars);
-	delete mutationStrings;
+	delete mutationRuns;
 	delete mutationChars;
 	delete insertions;
 	return ret;
 }
 
-void MultiMute::reverse(vector<string> * toAddTo) {
+void MultiMute::reverse(vector<Run> * toAddTo) {
 	//Keep forming strings until the allocation of reverse is used up
 	int size;
 	while(maxReverse > 0){
@@ -169,13 +167,12 @@ void MultiMute::reverse(vector<string> * toAddTo) {
 			}
 		}
 		//Add a string of the randomized size to the vector
-		string toAdd(size, 'R');
-		toAddTo->push_back(toAdd);
+		toAddTo->push_back(Run('R', size));
 		maxReverse -= size;
 	}
 }
 
-void MultiMute::translocate(vector<string> * toAddTo) {
+void MultiMute::translocate(vector<Run> * toAddTo) {
 	int size;
 	//Keep forming strings until the allocation of Translocate is used up
 	while(maxTrans > 0){
@@ -191,14 +188,13 @@ void MultiMute::translocate(vector<string> * toAddTo) {
 			}
 		}
 		//Add a string of the randomized size to the vector, and an I for where to translocate to
-		string toAdd(size, 'T');
-		toAddTo->push_back(toAdd);
-		toAddTo->push_back("I");
+		toAddTo->push_back(Run('T', size));
+		toAddTo->push_back(Run('I', 1));
 		maxTrans -= size;
 	}
 }
 
-void MultiMute::insert(vector<string> * toAddTo) {
+void MultiMute::insert(vector<Run> * toAddTo) {
 	int size;
 	//Keep forming strings until the allocation of insert is used up
 	while(maxInsert > 0){
@@ -214,13 +210,13 @@ void MultiMute::insert(vector<string> * toAddTo) {
 			}
 		}
 		//Add an I for where to insert, and add a generated string to the insetions vector
-		toAddTo->push_back("I");
+		toAddTo->push_back(Run('I', 1));
 		insertions->push_back(genInsert(size));
 		maxInsert -= size;
 	}
 }
 
-void MultiMute::deleteNucl(vector<string> * toAddTo) {
+void MultiMute::deleteNucl(vector<Run> * toAddTo) {
 	int size;
 	//Keep forming strings until the allocation of deletion is used up
 	while(maxDel > 0){
@@ -236,13 +232,12 @@ void MultiMute::deleteNucl(vector<string> * toAddTo) {
 			}
 		}
 		//Add a string of X's to show what nucleotides will be deleted
-		string toAdd(size, 'X');
-		toAddTo->push_back(toAdd);
+		toAddTo->push_back(Run('X', size));
 		maxDel -= size;
 	}
 }
 
-void MultiMute::duplicate(vector<string> * toAddTo) {
+void MultiMute::duplicate(vector<Run> * toAddTo) {
 	int size;
 	//Keep forming strings until the allocation of duplicate is used up
 	while(maxDup > 0){
@@ -258,8 +253,7 @@ void MultiMute::duplicate(vector<string> * toAddTo) {
 			}
 		}
 		//Add a string of D's for duplicate to the vector
-		string toAdd(size, 'D');
-		toAddTo->push_back(toAdd);
+		toAddTo->push_back(Run('D', size));
 		maxDup -= size;
 	}
 }
@@ -300,7 +294,6 @@ vector<bool> MultiMute::formatString(int maxSize, vector<char> * mutationsChars)
 	//vector that stores what indexes have/have not been mutated
 	vector<bool> validCharacters;
 	validCharacters.reserve(mutationsChars->size() * 2);
-	unsigned seed = 0;
     // Use of shuffle to randomize the order
 	shuffle(insertions->begin(), insertions->end(), generatorMultiMute);
 	int j = 0;
@@ -326,7 +319,6 @@ vector<bool> MultiMute::formatString(int maxSize, vector<char> * mutationsChars)
 		//For duplications, it will add each charceter, and then read a string of the added characters in the same order
 		else if(mutationsChars->at(j) == 'D'){
 			string temp2;
-			temp2.reserve(seq->length() - i);
 			for(; j < mutationsChars->size() && mutationsChars->at(j) == 'D' && i < seq->length(); j++, i++){
 				temp2.push_back(seq->at(i));
 				temp.push_back(seq->at(i));
@@ -349,9 +341,7 @@ vector<bool> MultiMute::formatString(int maxSize, vector<char> * mutationsChars)
 		}
 	}
 	//Reassign the string pointer
-	seq->erase();
-	seq->reserve(temp.length());
-	seq->append(temp);
+	seq->swap(temp);
 	return validCharacters;
 }
 
@@ -361,7 +351,6 @@ void MultiMute::getTranslocations(vector<char> * toParseFrom){
 		//If a T is found, the string of nucleotides with corresponding T's is copied and added to the insertion vector
 		if(toParseFrom->at(j) == 'T'){
 			string temp;
-			temp.reserve(seq->length() - i);
 			for(;j < toParseFrom->size() && toParseFrom->at(j) == 'T' && i < seq->length(); i++, j++){
 				temp.push_back(seq->at(i));
 			}
@@ -379,54 +368,72 @@ void MultiMute::getTranslocations(vector<char> * toParseFrom){
 	}
 }
 
-vector<char> * MultiMute::genCharVector(vector<string> * toParseFrom){
+vector<char> * MultiMute::genCharVector(vector<Run> * toParseFrom){
 	vector<char> * charVector = new vector<char>();
-	charVector->reserve(seq->length());
-	string temp;
-	//For every index
+	charVector->reserve(seq->length() + toParseFrom->size());
+	//Expand every run into its characters
 	for(int i = 0; i < toParseFrom->size(); i++){
-		temp = toParseFrom->at(i);
-		//Add each character in the string at the index, add it to the new character vector
-		for(int j = 0; j < temp.length(); j++){
-			charVector->push_back(temp.at(j));
-		}
+		const Run & run = toParseFrom->at(i);
+		charVector->insert(charVector->end(), run.second, run.first);
 	}
 	return charVector;
 }
 
-void MultiMute::checkForAllPalindromes(vector<string> * toParseFrom){
+int MultiMute::countElements(const Run & run){
+	return run.first == 'S' ? run.second : 1;
+}
+
+void MultiMute::checkForAllPalindromes(vector<Run> * toParseFrom){
 	int insertionChanges = 0;
 	for(int i = 0, j = 0; i < seq->length() && j < toParseFrom->size();){
+		Run & run = toParseFrom->at(j);
 		//If it is not a reversal
-		if(toParseFrom->at(j).at(0) != 'R'){
+		if(run.first != 'R'){
 			//If it is an insertion character, only increment the vector integer
-			if(toParseFrom->at(j).at(0) == 'I'){
+			if(run.first == 'I'){
 				j++;
 			}
-			//Otherwise, increment the string iterator by the length of the current string in the vector,
+			//Otherwise, increment the string iterator by the length of the current run,
 			//then increment the vector integer
 			else{
-				i += toParseFrom->at(j).length();
+				i += run.second;
 				j++;
 			}
 		}
 		else{
 			//If it is not a palindrome, incremtn as in the if statement
-			if(checkPalindrome(i, i + toParseFrom->at(j).length() - 1)){
-				i += toParseFrom->at(j).length();
+			if(checkPalindrome(i, i + run.second - 1)){
+				i += run.second;
 				j++;
 			}
 			//Otherwise, replace the reverse with a transversal
 			else{
-				string temp(toParseFrom->at(j).length(), 'T');
-				toParseFrom->at(j) = temp;
+				run.first = 'T';
 				insertionChanges++;
 			}
 		}
 	}
-	//Insert enough I's randomly for the amount of transversals that replaced reversals
+	//Insert enough I's randomly for the amount of transversals that replaced reversals.
+	//The index counts every S on its own, as if each were a separate string
+	int elements = 0;
+	for(int j = 0; j < toParseFrom->size(); j++){
+		elements += countElements(toParseFrom->at(j));
+	}
 	for(int i = 0; i < insertionChanges; i++){
-		int index = rand() % toParseFrom->size();
-		toParseFrom->insert(toParseFrom->begin() + index, "I");
+		int index = rand() % elements;
+		int j = 0;
+		while(index >= countElements(toParseFrom->at(j))){
+			index -= countElements(toParseFrom->at(j));
+			j++;
+		}
+		//Landing inside a run of S splits it around the new I
+		if(index > 0){
+			int rest = toParseFrom->at(j).second - index;
+			toParseFrom->at(j).second = index;
+			j++;
+			toParseFrom->insert(toParseFrom->begin() + j, Run('S', rest));
+		}
+		toParseFrom->insert(toParseFrom->begin() + j, Run('I', 1));
+		elements++;
 	}
 }
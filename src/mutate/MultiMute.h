@@ -62,34 +62,41 @@ public:
 	int maxNonMutations;
 	int alignmentLength;
 	int IBP;
+	/*
+	 A run of mutation characters of one type and its length.
+	 	Runs of S stand for one unmutated nucleotide per character,
+	 	so the plan stays short however long the sequence is
+	 */
+	typedef std::pair<char, int> Run;
 	std::vector<std::string> * insertions;
-	std::vector<string> * mutationStrings;
+	std::vector<Run> * mutationRuns;
 	std::string * seq;
 	/*
-	 Takes in a vector
+	 Reverses a random, nonmutaded part of the sequence,
+	 	no larger than its max allocation
 	 */
-	void reverse(vector<string> *);
+	void reverse(vector<Run> *);
 	/*
 	 Translocates a random, nonmutaded part of the sequence,
 	 	no larger than its max allocation
 	 */
-	void translocate(vector<string> *);
+	void translocate(vector<Run> *);
 	/*
 	 Inserts at random, nonmutaded part of the sequence,
 	 	no larger than its max allocation
 	 */
-	void insert(vector<string> *);
+	void insert(vector<Run> *);
 	/*
 	 Deletes a random, nonmutaded part of the sequence,
 	 	no larger than its max allocation
 	 */
-	void deleteNucl(vector<string> *);
+	void deleteNucl(vector<Run> *);
 	/*
 	 Duplicates a random, nonmutaded part of the sequence,
 	 	no larger than its max allocation
 	 	to an index directly after the duplicated string
 	 */
-	void duplicate(vector<string> *);
+	void duplicate(vector<Run> *);
 	/*
 	 Checks inclusively, [first, last], if a portion is valid
 
@@ -101,7 +108,12 @@ public:
 	 bool: true if all indexes in range are valid
 	 */
 	bool checkPalindrome(int, int);
-	void checkForAllPalindromes(vector<string> *);
+	void checkForAllPalindromes(vector<Run> *);
+	/*
+	 Counts the mutation strings a run stood for:
+	 	one per S, one for any other run
+	 */
+	static int countElements(const Run &);
 	/*
 	 Marks all indexes in the range as invalid
 
@@ -126,12 +138,12 @@ public:
 	*/
 	void getTranslocations(vector<char> *);
 	/*
-		converts a vector of strings into a vector of chars
+		converts a vector of runs into a vector of chars
 		@param:
-		vector<string> *: the vector to be converted
+		vector<Run> *: the vector to be converted
 		@return:
 		vector<char> *: the vector of characters
 	*/
-	vector<char> * genCharVector(vector<string> *);
+	vector<char> * genCharVector(vector<Run> *);
 };
 #endif
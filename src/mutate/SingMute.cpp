@@ -1,29 +1,36 @@
 #include "SingMute.h"
-#include <set>
 #include <random>
 
+static thread_local std::mt19937 intGenerator;
+static thread_local std::mt19937 longGenerator;
+
 int intRandMod(int max) {
-    static thread_local std::mt19937 generator;
     std::uniform_int_distribution<int> distribution(0, max-1);
-    return distribution(generator);
+    return distribution(intGenerator);
 }
 long longRandMod(long max) {
-    static thread_local std::mt19937 generator;
     std::uniform_int_distribution<long> distribution(0, max-1);
-    return distribution(generator);
+    return distribution(longGenerator);
 }
 
-
-void generate_unique_set(size_t cmd_size, std::set<long>& ret, int num_elts, const std::set<long>& bad_set_1, const std::set<long>& bad_set_2, const std::vector<bool> &valid)
+void SingMute::seed(unsigned value)
 {
-	while (ret.size() <= num_elts) {
-		long idx = longRandMod(cmd_size);
-		if (valid[idx] &&
-		    ret.find(idx) == ret.end() &&
-		    bad_set_1.find(idx) == bad_set_1.end() &&
-		    bad_set_2.find(idx) == bad_set_2.end()) {
+	intGenerator.seed(value);
+	longGenerator.seed(value);
+}
+
 
-			ret.insert(idx);
+/*
+ Marks num_elts + 1 random valid indexes of command_str, not marked yet, with cmd
+ */
+void generate_unique_set(std::vector<char>& command_str, char cmd, int num_elts, const std::vector<bool> &valid)
+{
+	size_t marked = 0;
+	while (marked <= num_elts) {
+		long idx = longRandMod(command_str.size());
+		if (valid[idx] && command_str[idx] == 'S') {
+			command_str[idx] = cmd;
+			marked++;
 		}
 	}
 }
@@ -83,19 +90,9 @@ void SingMute::init(const std::vector<bool> &valid)
 
 	std::vector<char> command_str(seq_len, 'S');
 
-	std::set<long> s_ins, s_del, s_switch;
-	generate_unique_set(command_str.size(), s_ins, maxInsert, s_del, s_switch, valid);
-	generate_unique_set(command_str.size(), s_del, maxDel, s_ins, s_switch, valid);
-	generate_unique_set(command_str.size(), s_switch, maxSwitch, s_ins, s_del, valid);
-	for (auto idx : s_ins) {
-		command_str[idx] = 'I';
-	}
-	for (auto idx : s_del) {
-		command_str[idx] = 'D';
-	}
-	for (auto idx : s_switch) {
-		command_str[idx] = 'W';
-	}
+	generate_unique_set(command_str, 'I', maxInsert, valid);
+	generate_unique_set(command_str, 'D', maxDel, valid);
+	generate_unique_set(command_str, 'W', maxSwitch, valid);
 	out_seq = "";
 	out_seq.reserve(maxInsert + seq_len - maxDel + 1);
 
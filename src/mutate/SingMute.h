@@ -21,6 +21,11 @@ public:
 														  percCs(pc), percGs(pg), percTs(pt), num_mut(tt), seq(s) {
 		init(valid_);
 	}
+	/*
+	 Restarts the generators of the calling thread,
+	 	so that the next mutations depend on the value only
+	 */
+	static void seed(unsigned);
 	long getAlignmentLength() { return alignmentLength; }
 	long getIBP() { return IBP; }
 	void init(const std::vector<bool> &valid);
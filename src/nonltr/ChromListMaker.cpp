@@ -8,6 +8,8 @@
 
 #include "ChromListMaker.h"
 
+#include <algorithm>
+
 namespace nonltr {
 
 ChromListMaker::ChromListMaker(string seqFileIn) {
@@ -47,186 +49,85 @@ ChromListMaker::~ChromListMaker() {
 	delete chromOSplitMap;
 }
 
-const vector<Chromosome *> * ChromListMaker::makeChromList() {
-	ifstream in(seqFile.c_str());
-	bool isFirst = true;
-	bool passedLimit = false;
-	Chromosome * chrom;
-	int seqLen = 0;
-	int seqIndex = 0;
-	while (in.good()) {
-		string line;
-		getline(in, line);
-
-		if (line[0] == '>') {
-			if (!isFirst) {
-				if (passedLimit) {
-					passedLimit = false;
-				}
-				pair<string, int> splitRegion(chrom->getHeader(), seqIndex);
-				seqLen = 0;
-				seqIndex = 0;
+/**
+ * Reads the records of the file into chromosomes of type C. With a limit, a
+ * record is cut into pieces of limit characters, each of them a chromosome
+ * with the header of the record; splitMap keeps the header and where each
+ * piece starts in its record. Lines are copied straight from the mapped file.
+ */
+template<class C>
+static void readRecords(string& seqFile, int limit, vector<C *> * list,
+		unordered_map<C *, pair<string, int>> * splitMap) {
+	FastaReader reader(seqFile);
+	int recordCount = reader.getRecordCount();
+
+	for (int r = 0; r < recordCount; r++) {
+		string header = reader.getHeader(r);
+		size_t offset = reader.getSequenceStart(r);
+		size_t end = reader.getSequenceEnd(r);
+		bool isLast = (r == recordCount - 1);
+
+		C * chrom = new C();
+		chrom->setHeader(header);
+		size_t span = end - offset;
+		chrom->getBaseRef().reserve(
+				limit ? min(span, (size_t) limit) : span);
+		chrom->appendToSequence(header.c_str(), 0);
+
+		int seqLen = 0;
+		int seqIndex = 0;
+		const char * line;
+		size_t lineLen;
+		while (reader.nextLine(offset, end, line, lineLen)) {
+			int len = lineLen;
+			while (limit && seqLen + len > limit) {
+				int part = limit - seqLen;
+				chrom->appendToSequence(line, part);
+				line += part;
+				len -= part;
+
+				pair<string, int> splitRegion(header, seqIndex);
 				chrom->finalize();
-				if (chrom->getEffectiveSize() > 0) {
-					chromList->push_back(chrom);
-					chromSplitMap->emplace(chrom, splitRegion);
+				int baseSize = chrom->getBase()->size();
+				if (chrom->getEffectiveSize() > 0
+						|| chrom->getSegment()->size() != 0) {
+					list->push_back(chrom);
+					splitMap->emplace(chrom, splitRegion);
 				} else {
 					delete chrom;
 				}
-			} else {
-				isFirst = false;
-			}
 
-			chrom = new Chromosome();
-			chrom->setHeader(line);
-		} else {
-			seqLen += line.size();
-
-			if (limit && seqLen > limit) {
-				passedLimit = true;
-				while (limit && seqLen > limit) {
-					const string * base = chrom->getBase();
-					string lineSubStr = line.substr(0,
-							line.size() - seqLen + limit);
-					line = line.substr(line.size() - seqLen + limit);
-
-					chrom->appendToSequence(lineSubStr);
-					string oldHeader = chrom->getHeader();
-					int baseSize = chrom->getBase()->size();
-
-					pair<string, int> splitRegion(chrom->getHeader(), seqIndex);
-
-					chrom->finalize();
-
-					if (chrom->getEffectiveSize() > 0
-							|| chrom->getSegment()->size() != 0) {
-						chromList->push_back(chrom);
-						chromSplitMap->emplace(chrom, splitRegion);
-					} else {
-						delete chrom;
-					}
-					chrom = new Chromosome();
-					chrom->setHeader(oldHeader);
-					seqLen = line.size();
-					seqIndex += baseSize;
-				}
-				if (line.size() > 0) {
-					chrom->appendToSequence(line);
-				}
-
-			} else {
-				chrom->appendToSequence(line);
+				chrom = new C();
+				chrom->setHeader(header);
+				chrom->getBaseRef().reserve(limit);
+				chrom->appendToSequence(line, 0);
+				seqLen = 0;
+				seqIndex += baseSize;
 			}
+			chrom->appendToSequence(line, len);
+			seqLen += len;
 		}
-		line.clear();
-	}
-	if (passedLimit) {
-		passedLimit = false;
-	}
-	pair<string, int> splitRegion(chrom->getHeader(), seqIndex);
-	chrom->finalize();
 
-	if (chrom->getEffectiveSize() > 0 || chrom->getSegment()->size() != 0) {
-		chromList->push_back(chrom);
-		chromSplitMap->emplace(chrom, splitRegion);
-	} else {
-		delete chrom;
+		// A record ending the file may be kept for its segments alone
+		pair<string, int> splitRegion(header, seqIndex);
+		chrom->finalize();
+		if (chrom->getEffectiveSize() > 0
+				|| (isLast && chrom->getSegment()->size() != 0)) {
+			list->push_back(chrom);
+			splitMap->emplace(chrom, splitRegion);
+		} else {
+			delete chrom;
+		}
 	}
+}
 
-	in.close();
-
+const vector<Chromosome *> * ChromListMaker::makeChromList() {
+	readRecords(seqFile, limit, chromList, chromSplitMap);
 	return chromList;
 }
 
-
 const vector<ChromosomeOneDigit *> * ChromListMaker::makeChromOneDigitList() {
-	ifstream in(seqFile.c_str());
-	bool isFirst = true;
-
-	ChromosomeOneDigit * chrom;
-	int seqLen = 0;
-	int seqIndex = 0;
-	while (in.good()) {
-		string line;
-		getline(in, line);
-		if (line[0] == '>') {
-			if (!isFirst) {
-				if (passedLimit) {
-					passedLimit = false;
-				}
-
-				pair<string, int> splitRegion(chrom->getHeader(), seqIndex);
-				seqLen = 0;
-				seqIndex = 0;
-				chrom->finalize();
-				if (chrom->getEffectiveSize() > 0) {
-					chromOList->push_back(chrom);
-					chromOSplitMap->emplace(chrom, splitRegion);
-				} else {
-					delete chrom;
-				}
-			} else {
-				isFirst = false;
-			}
-
-			chrom = new ChromosomeOneDigit();
-			chrom->setHeader(line);
-		} else {
-			seqLen += line.size();
-			if (limit && seqLen > limit) {
-
-				passedLimit = true;
-				while (limit && seqLen > limit) {
-					const string * base = chrom->getBase();
-					string lineSubStr = line.substr(0,
-							line.size() - seqLen + limit);
-					line = line.substr(line.size() - seqLen + limit);
-
-					chrom->appendToSequence(lineSubStr);
-
-					string oldHeader = chrom->getHeader();
-
-					pair<string, int> splitRegion(chrom->getHeader(), seqIndex);
-					chrom->finalize();
-					int baseSize = chrom->getBase()->size();
-
-					if (chrom->getEffectiveSize() > 0
-							|| chrom->getSegment()->size() != 0) {
-						chromOList->push_back(chrom);
-						chromOSplitMap->emplace(chrom, splitRegion);
-					} else {
-						delete chrom;
-					}
-
-					chrom = new ChromosomeOneDigit();
-					chrom->setHeader(oldHeader);
-					seqLen = line.size();
-					seqIndex += baseSize;
-				}
-
-				if (line.size() > 0) {
-					chrom->appendToSequence(line);
-				}
-
-			} else {
-				chrom->appendToSequence(line);
-			}
-		}
-	}
-	if (passedLimit) {
-		passedLimit = false;
-	}
-	pair<string, int> splitRegion(chrom->getHeader(), seqIndex);
-	chrom->finalize();
-
-	if (chrom->getEffectiveSize() > 0 || chrom->getSegment()->size() != 0) {
-		chromOList->push_back(chrom);
-		chromOSplitMap->emplace(chrom, splitRegion);
-	} else {
-		delete chrom;
-	}
-
-	in.close();
+	readRecords(seqFile, limit, chromOList, chromOSplitMap);
 	return chromOList;
 }
 
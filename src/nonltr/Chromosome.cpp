@@ -87,6 +87,20 @@ void Chromosome::appendToSequence(string& line) {
 	}
 }
 
+/**
+ * Appends len characters starting at line, e.g. a line of a mapped file
+ */
+void Chromosome::appendToSequence(const char * line, int len) {
+	if (isFinalized) {
+		string msg("This chromosome has been finalized. ");
+		msg.append("The sequence cannot be modified.");
+		throw InvalidOperationException(msg);
+	} else {
+		base.append(line, len);
+		isBaseReady = true;
+	}
+}
+
 void Chromosome::finalize() {
 	if (isFinalized) {
 		string msg("This chromosome has been already finalized. ");
@@ -107,14 +121,10 @@ void Chromosome::help(int len, bool canMerge) {
 
 	effectiveSize = 0;
 	segLength = len;
-	segment = new vector<vector<int> *>();
-
-	toUpperCase();
+	segment.clear();
 
 	baseCount = new vector<int>(4, 0);
-	makeBaseCount();
-
-	removeN();
+	scanBases();
 
 	if (canMerge && base.size() > 20) {
 		mergeSegments();
@@ -129,125 +139,111 @@ Chromosome::~Chromosome() {
 	base.clear();
 
 	if (canClean) {
-		while (!segment->empty()) {
-			segment->back()->clear();
-			delete segment->back();
-			segment->pop_back();
-		}
-		segment->clear();
-		delete segment;
-
 		baseCount->clear();
 		delete baseCount;
 	}
 }
 
 void Chromosome::readFasta() {
-	bool isFirst = true;
-	header = string("");
-	base = string("");
-
-	ifstream in(chromFile.c_str());
-	if (in.fail()) {
-		string msg("Cannot open ");
-		msg.append(chromFile);
-		msg.append(". System code is: ");
-		msg.append(Util::int2string(errno));
-		throw InvalidInputException(msg);
-	}
-
-	while (in.good()) {
-		string line;
-		getline(in, line);
-		if (line[0] == '>') {
-			if (!isFirst) {
-				string msg = "Chromosome file: ";
-				msg = msg + chromFile;
-				msg =
-				msg
-				+ " must have one sequence only. But it has more than one.";
-				throw InvalidInputException(msg);
-			} else {
-				header = line;
-				isFirst = false;
-			}
-		} else {
-			base.append(line);
-		}
-	}
-	in.close();
+	readFasta(-1);
 }
 
+/**
+ * Reads whole lines until the sequence has at least maxLength characters;
+ * a negative maxLength reads the whole sequence.
+ */
 void Chromosome::readFasta(int maxLength) {
-	bool isFirst = true;
+	FastaReader reader(chromFile);
+	int recordCount = reader.getRecordCount();
+
 	header = string("");
 	base = string("");
+	size_t offset = 0;
+	size_t end = reader.getSize();
+	if (recordCount > 0) {
+		header = reader.getHeader(0);
+		offset = reader.getSequenceStart(0);
+		end = reader.getSequenceEnd(0);
+	}
+	if (maxLength < 0) {
+		base.reserve(end - offset);
+	}
 
-	ifstream in(chromFile.c_str());
-	if (in.fail()) {
-		string msg("Cannot open ");
-		msg.append(chromFile);
-		msg.append(". System code is: ");
-		msg.append(Util::int2string(errno));
-		throw InvalidInputException(msg);
+	const char * line;
+	size_t len;
+	while ((maxLength < 0 || base.size() < maxLength)
+			&& reader.nextLine(offset, end, line, len)) {
+		base.append(line, len);
 	}
 
-	while (in.good() && base.size() < maxLength) {
-		string line;
-		getline(in, line);
-		if (line[0] == '>') {
-			if (!isFirst) {
-				string msg = "Chromosome file: ";
-				msg = msg + chromFile;
-				msg =
-				msg
-				+ " must have one sequence only. But it has more than one.";
-				throw InvalidInputException(msg);
-			} else {
-				header = line;
-				isFirst = false;
-			}
-		} else {
-			base.append(line);
-		}
+	if (recordCount > 1 && (maxLength < 0 || base.size() < maxLength)) {
+		string msg = "Chromosome file: ";
+		msg = msg + chromFile;
+		msg = msg + " must have one sequence only. But it has more than one.";
+		throw InvalidInputException(msg);
 	}
-	in.close();
 }
 
 /**
- * Convert alphabet to upper case if it has not been done before
- **/
-void Chromosome::toUpperCase() {
-	for (int i = 0; i < base.length(); i++) {
-		base[i] = toupper(base[i]);
+ * Upper case and base index of every byte value; the index of a byte
+ * that is not A, C, G or T is 4
+ */
+namespace {
+	struct BaseTable {
+		char upper[256];
+		char index[256];
+
+		BaseTable() {
+			for (int c = 0; c < 256; c++) {
+				upper[c] = toupper(c);
+				index[c] = 4;
+			}
+			index['A'] = 0;
+			index['C'] = 1;
+			index['G'] = 2;
+			index['T'] = 3;
+		}
+	};
+
+	const BaseTable& baseTable() {
+		static const BaseTable table;
+		return table;
 	}
 }
 
 /**
+ * Converts the alphabet to upper case, counts the bases and stores the
+ * non-N segments in one pass over the sequence.
  * Segment coordinates are inclusive [s,e]
  **/
-void Chromosome::removeN() {
+void Chromosome::scanBases() {
+	const BaseTable& table = baseTable();
+	int count[5] = { 0, 0, 0, 0, 0 };
+	int size = base.size();
+	char * b = &base[0];
+
 	// Store non-N index
 	int start = -1;
-	for (int i = 0; i < base.size(); i++) {
-		if (base[i] != 'N' && start == -1) {
+	for (int i = 0; i < size; i++) {
+		char c = table.upper[(unsigned char) b[i]];
+		b[i] = c;
+		count[(int) table.index[(unsigned char) c]]++;
+
+		if (c != 'N' && start == -1) {
 			start = i;
-		} else if (base[i] == 'N' && start != -1) {
-			vector<int> * v = new vector<int>();
-			v->push_back(start);
-			v->push_back(i - 1);
-			segment->push_back(v);
+		} else if (c == 'N' && start != -1) {
+			segment.add(start, i - 1);
 
 			start = -1;
-		} else if (i == base.size() - 1 && base[i] != 'N' && start != -1) {
-			vector<int> * v = new vector<int>();
-			v->push_back(start);
-			v->push_back(i);
-
-			segment->push_back(v);
+		} else if (i == size - 1 && c != 'N' && start != -1) {
+			segment.add(start, i);
 			start = -1;
 		}
 	}
+
+	for (int k = 0; k < 4; k++) {
+		baseCount->at(k) = count[k];
+	}
 }
 
 /**
@@ -255,24 +251,21 @@ void Chromosome::removeN() {
  * Segments that are shorter than 20 bp are not added.
  */
 void Chromosome::mergeSegments() {
-	if (segment->size() > 0) {
-		vector<vector<int> *> * mSegment = new vector<vector<int> *>();
-		int s = segment->at(0)->at(0);
-		int e = segment->at(0)->at(1);
+	if (segment.size() > 0) {
+		SegmentList mSegment;
+		int s = segment.getStart(0);
+		int e = segment.getEnd(0);
 
-		for (int i = 1; i < segment->size(); i++) {
-			int s1 = segment->at(i)->at(0);
-			int e1 = segment->at(i)->at(1);
+		for (int i = 1; i < segment.size(); i++) {
+			int s1 = segment.getStart(i);
+			int e1 = segment.getEnd(i);
 
 			if (s1 - e < 10) {
 				e = e1;
 
 			} else {
 				if (e - s + 1 >= 20) {
-					vector<int> * seg = new vector<int>();
-					seg->push_back(s);
-					seg->push_back(e);
-					mSegment->push_back(seg);
+					mSegment.add(s, e);
 				}
 
 				s = s1;
@@ -282,25 +275,20 @@ void Chromosome::mergeSegments() {
 
 		// Handle the last index
 		if (e - s + 1 >= 20) {
-			vector<int> * seg = new vector<int>();
-			seg->push_back(s);
-			seg->push_back(e);
-			mSegment->push_back(seg);
+			mSegment.add(s, e);
 		}
 
-		Util::deleteInVector(segment);
-		segment->clear();
-		delete segment;
-		segment = mSegment;
+		segment.swap(mSegment);
 	}
 }
 
 void Chromosome::makeSegmentList() {
-	vector<vector<int> *> * segmentList = new vector<vector<int> *>();
-	int segmentCount = segment->size();
+	SegmentList segmentList;
+	int segmentCount = segment.size();
+	segmentList.reserve(segmentCount);
 	for (int oo = 0; oo < segmentCount; oo++) {
-		int s = segment->at(oo)->at(0);
-		int e = segment->at(oo)->at(1);
+		int s = segment.getStart(oo);
+		int e = segment.getEnd(oo);
 
 		if (e - s + 1 > segLength) {
 			int fragNum = (int) (e - s + 1) / segLength;
@@ -309,22 +297,14 @@ void Chromosome::makeSegmentList() {
 				int fragStart = s + (h * segLength);
 				int fragEnd =
 				(h == fragNum - 1) ? e : fragStart + segLength - 1;
-				vector<int> * v = new vector<int>();
-				v->push_back(fragStart);
-				v->push_back(fragEnd);
-				segmentList->push_back(v);
+				segmentList.add(fragStart, fragEnd);
 			}
 		} else {
-			vector<int> * v = new vector<int>();
-			v->push_back(segment->at(oo)->at(0));
-			v->push_back(segment->at(oo)->at(1));
-			segmentList->push_back(v);
+			segmentList.add(s, e);
 		}
 	}
 
-	Util::deleteInVector(segment);
-	delete segment;
-	segment = segmentList;
+	segment.swap(segmentList);
 }
 
 
@@ -392,16 +372,16 @@ string& Chromosome::getHeaderRef() {
 	return header;
 }
 
-const vector<vector<int> *> * Chromosome::getSegment() {
-	return segment;
+const SegmentList * Chromosome::getSegment() {
+	return &segment;
 }
 
 void Chromosome::printSegmentList() {
-	int l = segment->size();
+	int l = segment.size();
 	cout << "Segment list size = " << l << endl;
 	for (int i = 0; i < l; i++) {
-		cout << segment->at(i)->at(0) << "\t";
-		cout << segment->at(i)->at(1) << endl;
+		cout << segment.getStart(i) << "\t";
+		cout << segment.getEnd(i) << endl;
 	}
 }
 
@@ -414,11 +394,9 @@ int Chromosome::size() {
 }
 
 void Chromosome::calculateEffectiveSize() {
-	int segmentCount = segment->size();
+	int segmentCount = segment.size();
 	for (int oo = 0; oo < segmentCount; oo++) {
-		int s = segment->at(oo)->at(0);
-		int e = segment->at(oo)->at(1);
-		effectiveSize += (e - s + 1);
+		effectiveSize += segment.getLength(oo);
 	}
 }
 
@@ -438,25 +416,6 @@ int Chromosome::getGcContent() {
 	return gc;
 }
 
-void Chromosome::makeBaseCount() {
-	int size = base.size();
-	for (int i = 0; i < size; i++) {
-		switch (base.at(i)) {
-			case 'A':
-			baseCount->at(0)++;break
-			;			case 'C':
-			baseCount->at(1)++;
-			break;
-			case 'G':
-			baseCount->at(2)++;
-			break;
-			case 'T':
-			baseCount->at(3)++;
-			break;
-		}
-	}
-}
-
 vector<int> * Chromosome::getBaseCount() {
 	return baseCount;
 }
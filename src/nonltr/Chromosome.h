@@ -17,6 +17,7 @@
 #include "../exception/InvalidOperationException.h"
 #include "../exception/InvalidInputException.h"
 #include "../utility/Util.h"
+#include "../utility/FastaReader.h"
 
 using namespace std;
 using namespace nonltr;
@@ -42,7 +43,7 @@ public:
 	virtual string& getHeaderRef();
 
 	virtual const string* getBase();
-	virtual const vector<vector<int> *> * getSegment();
+	virtual const SegmentList * getSegment();
 	virtual void printSegmentList();
 	virtual string getHeader();
 	virtual int size();
@@ -50,6 +51,7 @@ public:
 	virtual void setHeader(string&);
 	virtual void setSequence(string&);
 	virtual void appendToSequence(string&);
+	virtual void appendToSequence(const char *, int);
 	virtual void finalize();
 	virtual vector<int> * getBaseCount();
 	virtual std::vector<std::string> * getSequenceFromLocations(std::string);
@@ -61,16 +63,14 @@ protected:
 	int effectiveSize;
 	int segLength;
 
-	vector<vector<int> *> * segment;
+	SegmentList segment;
 	void readFasta();
 	void readFasta(int);
-	void toUpperCase();
-	void removeN();
+	void scanBases();
 	void mergeSegments();
 	virtual void help(int, bool);
 	void makeSegmentList();
 	void calculateEffectiveSize();
-	virtual void makeBaseCount();
 	vector<int> * baseCount;
 
 private:
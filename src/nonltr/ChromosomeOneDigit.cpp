@@ -56,8 +56,6 @@ namespace nonltr {
 	}
 
 	void ChromosomeOneDigit::help() {
-	// Build codes
-		buildCodes();
 	// Modify the sequence in the super class
 		encodeNucleotides();
 	}
@@ -67,103 +65,97 @@ namespace nonltr {
 		help();
 	}
 
-	void ChromosomeOneDigit::buildCodes() {
-	// Can delete the codes
-		canClean = true;
-
-	// Make map
-		codes = new map<char, char>();
-
-	// Certain nucleotides
-		codes->insert(map<char, char>::value_type('A', (char) 0));
-		codes->insert(map<char, char>::value_type('C', (char) 1));
-		codes->insert(map<char, char>::value_type('G', (char) 2));
-		codes->insert(map<char, char>::value_type('T', (char) 3));
-
-		codes->insert(map<char, char>::value_type((char) 0, (char) 0));
-		codes->insert(map<char, char>::value_type((char) 1, (char) 1));
-		codes->insert(map<char, char>::value_type((char) 2, (char) 2));
-		codes->insert(map<char, char>::value_type((char) 3, (char) 3));
-
-	// Common uncertain nucleotide
-	// codes->insert(map<char, char>::value_type('N', (char) 4));
-
-	// Uncertain nucleotides
-		codes->insert(map<char, char>::value_type('R', codes->at('G')));
-		codes->insert(map<char, char>::value_type('Y', codes->at('C')));
-		codes->insert(map<char, char>::value_type('M', codes->at('A')));
-		codes->insert(map<char, char>::value_type('K', codes->at('T')));
-		codes->insert(map<char, char>::value_type('S', codes->at('G')));
-		codes->insert(map<char, char>::value_type('W', codes->at('T')));
-		codes->insert(map<char, char>::value_type('H', codes->at('C')));
-		codes->insert(map<char, char>::value_type('B', codes->at('T')));
-		codes->insert(map<char, char>::value_type('V', codes->at('A')));
-		codes->insert(map<char, char>::value_type('D', codes->at('T')));
-		codes->insert(map<char, char>::value_type('N', codes->at('C')));
-		codes->insert(map<char, char>::value_type('X', codes->at('G')));
-	}
-
 	ChromosomeOneDigit::~ChromosomeOneDigit() {
-		if (canClean) {
-			codes->clear();
-			delete codes;
-		}
 	}
 
 /**
- * This method converts nucleotides in the segments to single digit codes
+ * The code of every byte value; invalid bytes are marked with INVALID.
+ * Inside segments N stands for C. Outside segments N is kept.
  */
-	void ChromosomeOneDigit::encodeNucleotides() {
+	namespace {
+		const char INVALID = (char) 0xFF;
 
-		for (int s = 0; s < segment->size(); s++) {
-			int segStart = segment->at(s)->at(0);
-			int segEnd = segment->at(s)->at(1);
-			for (int i = segStart; i <= segEnd; i++) {
+		struct CodeTable {
+			char inside[256];
+			char outside[256];
+
+			CodeTable() {
+				for (int c = 0; c < 256; c++) {
+					inside[c] = INVALID;
+				}
+
+			// Certain nucleotides
+				inside['A'] = 0;
+				inside['C'] = 1;
+				inside['G'] = 2;
+				inside['T'] = 3;
+
+				inside[0] = 0;
+				inside[1] = 1;
+				inside[2] = 2;
+				inside[3] = 3;
+
+			// Uncertain nucleotides
+				inside['R'] = inside['G'];
+				inside['Y'] = inside['C'];
+				inside['M'] = inside['A'];
+				inside['K'] = inside['T'];
+				inside['S'] = inside['G'];
+				inside['W'] = inside['T'];
+				inside['H'] = inside['C'];
+				inside['B'] = inside['T'];
+				inside['V'] = inside['A'];
+				inside['D'] = inside['T'];
+				inside['N'] = inside['C'];
+				inside['X'] = inside['G'];
+
+				for (int c = 0; c < 256; c++) {
+					outside[c] = inside[c];
+				}
+				outside['N'] = 'N';
+			}
+		};
+
+		const CodeTable& codeTable() {
+			static const CodeTable table;
+			return table;
+		}
 
-				if (codes->count(base[i]) > 0) {
-					base[i] = codes->at(base[i]);
-				} else {
+		void encode(string& base, int start, int end, const char * code) {
+			char * b = &base[0];
+			for (int i = start; i <= end; i++) {
+				char c = code[(unsigned char) b[i]];
+				if (c == INVALID) {
 					string msg = "Invalid nucleotide: ";
-					msg.append(1, base[i]);
+					msg.append(1, b[i]);
 					throw InvalidInputException(msg);
 				}
+				b[i] = c;
 			}
 		}
+	}
 
-	// Digitize skipped segments
-		int segNum = segment->size();
-		if (segNum > 0) {
-		// The first interval - before the first segment
-			int segStart = 0;
-			int segEnd = segment->at(0)->at(0) - 1;
-
-			for (int s = 0; s <= segNum; s++) {
-				for (int i = segStart; i <= segEnd; i++) {
-					char c = base[i];
-
-					if (c != 'N') {
-						if (codes->count(c) > 0) {
-							base[i] = codes->at(c);
-						} else {
-							string msg = "Invalid nucleotide: ";
-							msg.append(1, c);
-							throw InvalidInputException(msg);
-						}
-					}
-				}
+/**
+ * This method converts nucleotides to single digit codes in one pass over
+ * the segments and the skipped intervals between them. Nothing is
+ * converted if there are no segments.
+ */
+	void ChromosomeOneDigit::encodeNucleotides() {
+		const CodeTable& table = codeTable();
+		int segNum = segment.size();
+		if (segNum == 0) {
+			return;
+		}
 
-			// The regular intervals between two segments
-				if (s < segNum - 1) {
-					segStart = segment->at(s)->at(1) + 1;
-					segEnd = segment->at(s + 1)->at(0) - 1;
-				}
-			// The last interval - after the last segment
-				else if (s == segNum - 1) {
-					segStart = segment->at(s)->at(1) + 1;
-					segEnd = base.size() - 1;
-				}
-			}
+		int next = 0;
+		for (int s = 0; s < segNum; s++) {
+			int segStart = segment.getStart(s);
+			int segEnd = segment.getEnd(s);
+			encode(base, next, segStart - 1, table.outside);
+			encode(base, segStart, segEnd, table.inside);
+			next = segEnd + 1;
 		}
+		encode(base, next, base.size() - 1, table.outside);
 	}
 
 
@@ -278,28 +270,7 @@ namespace nonltr {
 	}
 
 	void ChromosomeOneDigit::reverseSegments() {
-		int segNum = segment->size();
-		int lastBase = size() - 1;
-
-	// Calculate the coordinate on the main strand
-		for (int i = 0; i < segNum; i++) {
-			vector<int> * seg = segment->at(i);
-
-			int s = lastBase - seg->at(1);
-			int e = lastBase - seg->at(0);
-			seg->clear();
-			seg->push_back(s);
-			seg->push_back(e);
-		}
-
-	// Reverse the regions within the list
-		int lastRegion = segNum - 1;
-		int middle = segNum / 2;
-		for (int i = 0; i < middle; i++) {
-			vector<int> * temp = segment->at(lastRegion - i);
-			(*segment)[lastRegion - i] = segment->at(i);
-			(*segment)[i] = temp;
-		}
+		segment.reverse(size() - 1);
 	}
 
 
@@ -15,14 +15,8 @@ namespace nonltr {
 	class ChromosomeOneDigit: public Chromosome {
 
 	private:
-		bool canClean = false;
-
-	/* Fields */
-		map<char, char> * codes;
-
 	/* Methods */
 		void help();
-		void buildCodes();
 		void encodeNucleotides();
 
 		void makeReverse();
@@ -35,13 +35,17 @@
  	}
 
  	ChromosomeRandom::ChromosomeRandom(int nIn, ChromosomeOneDigit* oChromIn,
- 		char unreadIn, int length) {
+ 		char unreadIn, int length, bool isGenerated) {
  		canDelete = false;
- 		initializer(nIn, oChromIn, unreadIn, length);
+ 		initializer(nIn, oChromIn, unreadIn, length, isGenerated);
  	}
 
+/**
+ * The segments are always made. Unless isGenerated is set, the sequence is
+ * left unread until generate() is called or a subclass fills it.
+ */
  	void ChromosomeRandom::initializer(int nIn, ChromosomeOneDigit* oChromIn,
- 		char unreadIn, int length) {
+ 		char unreadIn, int length, bool isGenerated) {
 	// Check the order
  		if (nIn < 0) {
  			string msg("The Markov order must be non-negative. ");
@@ -74,11 +78,17 @@
  		printCodes->insert(map<char, char>::value_type('n', 'n'));
  		printCodes->insert(map<char, char>::value_type('N', 'N'));
 
- 		randSegmentList = new vector<vector<int> *>();
+ 		randSegmentList = new SegmentList();
+
+ 		makeSegmentList();
+ 		if (isGenerated) {
+ 			generate();
+ 		}
+ 	}
 
+ 	void ChromosomeRandom::generate() {
  		countWords();
  		convertToProbabilities();
- 		makeSegmentList();
  		generateRandomSequence();
  	}
 
@@ -88,19 +98,18 @@
  		delete table;
  		delete rBase;
 
- 		Util::deleteInVector(randSegmentList);
  		delete randSegmentList;
  	}
 
  	void ChromosomeRandom::countWords() {
- 		const vector<vector<int> *> * segmentList = oChrom->getSegment();
+ 		const SegmentList * segmentList = oChrom->getSegment();
  		int segmentCount = segmentList->size();
 
  		const char * oCharBase = oBase->c_str();
 
  		for (int i = 0; i < segmentCount; i++) {
- 			table->wholesaleIncrement(oCharBase, segmentList->at(i)->at(0),
- 				segmentList->at(i)->at(1) - n + 1);
+ 			table->wholesaleIncrement(oCharBase, segmentList->getStart(i),
+ 				segmentList->getEnd(i) - n + 1);
  		}
  	}
 
@@ -123,23 +132,19 @@
  */
  void ChromosomeRandom::makeSegmentList() {
 	// Get the original segments
- 	const vector<vector<int> *> * segmentList = oChrom->getSegment();
+ 	const SegmentList * segmentList = oChrom->getSegment();
  	int segmentCount = segmentList->size();
 
  	int total = 0;
  	for (int i = 0; i < segmentCount; i++) {
- 		int s = segmentList->at(i)->at(0);
- 		int e = segmentList->at(i)->at(1);
+ 		int s = segmentList->getStart(i);
+ 		int e = segmentList->getEnd(i);
 
  		if (e < randLength) {
- 			randSegmentList->push_back(new vector<int>(*segmentList->at(i)));
+ 			randSegmentList->add(s, e);
  		} else {
  			if (s < randLength) {
- 				vector<int> * segment = new vector<int>();
- 				segment->push_back(s);
- 				segment->push_back(randLength - 1);
-
- 				randSegmentList->push_back(segment);
+ 				randSegmentList->add(s, randLength - 1);
  			}
  			break;
  		}
@@ -147,23 +152,20 @@
 
  	// Handle the case when the real chromsome is shorter than
  	// the desired length
- 	auto lastSegment = randSegmentList->back();
- 	if(lastSegment->at(1) < randLength-1){
- 		lastSegment->at(1) = randLength-1;
+ 	int lastSegment = randSegmentList->size() - 1;
+ 	if(randSegmentList->getEnd(lastSegment) < randLength-1){
+ 		randSegmentList->setEnd(lastSegment, randLength-1);
  	}
 
 
 	//Post condition
  	for (int i = 0; i < randSegmentList->size(); i++) {
- 		auto seg = randSegmentList->at(i);
- 		Location loc(seg->at(0), seg->at(1));
+ 		Location loc(randSegmentList->getStart(i), randSegmentList->getEnd(i));
  	}
 
 	// Post condition
  	for (int i = 1; i < randSegmentList->size(); i++) {
- 		auto seg1 = randSegmentList->at(i - 1);
- 		auto seg2 = randSegmentList->at(i);
- 		if (seg2->at(0) <= seg1->at(1)) {
+ 		if (randSegmentList->getStart(i) <= randSegmentList->getEnd(i - 1)) {
  			cerr << "ChromosomeRandom::makeSegmentList(): "
  			<< "Error while constructing segments" << endl;
  			throw std::exception();
@@ -178,74 +180,77 @@
 	// Alphabet count
  	int alphaCount = 4;
 
+	// The lottery of each context, i.e. the last n - 1 bases: base k wins
+	// a draw of at most periodEnd[context * 4 + k], and the draw is below
+	// chance[context]. Each base gets 100 * its probability tickets, plus
+	// one.
+ 	int tableSize = table->getMaxTableSize();
+ 	int contextCount = tableSize / alphaCount;
+ 	vector<int> periodEnd(tableSize);
+ 	vector<int> chance(contextCount);
+ 	for (int c = 0; c < contextCount; c++) {
+ 		int chanceSoFar = 0;
+ 		for (int k = 0; k < alphaCount; k++) {
+ 			double p = table->valueOf(c * alphaCount + k);
+ 			if (p > 0) {
+ 				int periodStart = chanceSoFar;
+ 				periodEnd[c * alphaCount + k] = periodStart + (100 * p);
+ 				chanceSoFar = periodEnd[c * alphaCount + k] + 1;
+ 			} else {
+ 				string msg("This word must exist in the table: ");
+ 				msg.append(Util::int2string(c * alphaCount + k));
+ 				msg.append(".");
+ 				throw InvalidStateException(msg);
+ 			}
+ 		}
+ 		chance[c] = chanceSoFar;
+ 	}
+ 	const int contextMask = contextCount - 1;
+
 	//CHANGE THIS AFTER TESTING
 	// srand(1);
  	std::default_random_engine generator;
+ 	std::uniform_int_distribution<int> distribution;
+ 	typedef std::uniform_int_distribution<int>::param_type Range;
+ 	char * rChars = &(*rBase)[0];
 
 	// Generate random segments
  	int segmentCount = randSegmentList->size();
  	for (int i = 0; i < segmentCount; i++) {
- 		int s = randSegmentList->at(i)->at(0);
- 		int e = randSegmentList->at(i)->at(1);
+ 		int s = randSegmentList->getStart(i);
+ 		int e = randSegmentList->getEnd(i);
 
  		if (e - s + 1 > n) {
- 			string order("");
+ 			int context = 0;
 
 			// The first order is based on the original sequence.
  			for (int w = s; w < s + n - 1; w++) {
- 				(*rBase)[w] = oBase->at(w);
- 				order.append(1, oBase->at(w));
+ 				char c = oBase->at(w);
+ 				if (c < 0 || c > 3) {
+ 					string msg("The value of the char representing the nucleotide ");
+ 					msg.append("must be between 0 and 3.");
+ 					msg.append("The int value is ");
+ 					msg.append(Util::int2string((int) c));
+ 					throw InvalidInputException(msg);
+ 				}
+ 				rChars[w] = c;
+ 				context = context * alphaCount + c;
  			}
 
+			// Subsequent orders are based on the random sequence.
  			for (int h = s + n - 1; h <= e; h++) {
-				// Subsequent orders are based on the random sequence.
- 				vector<vector<int> > lottery;
- 				int chanceSoFar = 0;
- 				for (int k = 0; k < alphaCount; k++) {
- 					string temp = order;
-					temp.append(1, k); // Change to k
-					if (table->valueOf(temp.c_str()) > 0) {
-						int periodStart = chanceSoFar;
-						int periodEnd = periodStart
-						+ (100 * table->valueOf(temp.c_str()));
-						chanceSoFar = periodEnd + 1;
-						vector<int> entry;
-						entry.push_back(k);
-						entry.push_back(periodStart);
-						entry.push_back(periodEnd);
-						lottery.push_back(entry);
-					} else {
-						string msg("This word must exist in the table: ");
-						msg.append(temp);
-						msg.append(".");
-						throw InvalidStateException(msg);
-					}
-				}
-
-				if (lottery.size() > 0) {
-					// int randInt = rand() % chanceSoFar;
-					std::uniform_int_distribution<int> distribution(0,chanceSoFar - 1);
-					int randInt = distribution(generator);
-
-
-
-					for (int tt = 0; tt < alphaCount; tt++) {
-						vector<int> entry = lottery.at(tt);
-						if (randInt >= entry.at(1) && randInt <= entry.at(2)) {
-							(*rBase)[h] = entry.at(0);
-							order.append(1, entry.at(0));
-							break;
-						}
-					}
-					lottery.clear();
-				} else {
-					string msg("The lottery vector cannot be empty.");
-					throw InvalidStateException(msg);
-				}
-				order = order.substr(1);
-			}
-		}
-	}
+ 				const int * end = &periodEnd[context * alphaCount];
+ 				int randInt = distribution(generator,
+ 						Range(0, chance[context] - 1));
+ 				int k = 0;
+ 				while (randInt > end[k]) {
+ 					k++;
+ 				}
+ 				rChars[h] = k;
+ 				context = (context * alphaCount + k) & contextMask;
+ 			}
+ 		}
+ 	}
 
 	// Make sure that the generated sequence has the desired length
 	if (randLength != rBase->size()) {
@@ -260,7 +265,7 @@
 /**
  * Returns the segments of the original chromosome
  */
- const vector<vector<int> *> * ChromosomeRandom::getSegment() {
+ const SegmentList * ChromosomeRandom::getSegment() {
  	return randSegmentList;
  }
 
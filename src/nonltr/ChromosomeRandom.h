@@ -29,7 +29,7 @@ namespace nonltr {
 		map<char, char> * printCodes;
 		KmerHashTable<int, double> * table;
 		ChromosomeOneDigit* oChromOneDigit;
-		vector<vector<int> *> * randSegmentList;
+		SegmentList * randSegmentList;
 
 		void countWords();
 		void convertToProbabilities();
@@ -39,14 +39,16 @@ namespace nonltr {
 	protected:
 		string * rBase;
 
+		void generate();
+
 	public:
 		ChromosomeRandom(int, ChromosomeOneDigit*, char);
-		ChromosomeRandom(int, ChromosomeOneDigit*, char, int);
-		void initializer(int, ChromosomeOneDigit*, char, int);
+		ChromosomeRandom(int, ChromosomeOneDigit*, char, int, bool = true);
+		void initializer(int, ChromosomeOneDigit*, char, int, bool = true);
 		virtual ~ChromosomeRandom();
 
 		virtual const string* getBase();
-		virtual const vector<vector<int> *> * getSegment();
+		virtual const SegmentList * getSegment();
 		virtual string getHeader();
 		virtual void printSequence(string);
 		void printSequence(string, string *);
@@ -9,27 +9,63 @@
 
 
 ChromosomeReadTR::ChromosomeReadTR(int nIn, ChromosomeOneDigit *oChromIn,
-	char unreadIn, int length, std::string fa_file, std::string bed_file, int seed_in) : ChromosomeTR(nIn, oChromIn, unreadIn, length, seed_in)
+	char unreadIn, int length, std::string fa_file, std::string bed_file, int seed_in,
+	std::string cacheDir) : ChromosomeTR(nIn, oChromIn, unreadIn, length, seed_in, cacheDir.empty())
 {
-	regionList = new std::vector<ILocation *>();
+	regionList = new std::vector<Region>();
 	repeatList = new std::vector<std::string>();
 
 	readTRList = oChromIn->getSequenceFromLocations(bed_file);
 
-	shuffle();
+	shuffleWithCache(oChromIn, nIn, length, seed_in, cacheDir);
 }
 
 ChromosomeReadTR::ChromosomeReadTR(int nIn, ChromosomeOneDigit *oChromIn,
 	char unreadIn, int length, std::string fa_file, std::string bed_file,
-	ChromosomeOneDigit * read_from_chrom, int seed_in) : ChromosomeTR(nIn, oChromIn, unreadIn, length, seed_in)
+	ChromosomeOneDigit * read_from_chrom, int seed_in,
+	std::string cacheDir) : ChromosomeTR(nIn, oChromIn, unreadIn, length, seed_in, cacheDir.empty())
 {
-	regionList = new std::vector<ILocation *>();
+	regionList = new std::vector<Region>();
 	repeatList = new std::vector<std::string>();
 
 	readTRList = read_from_chrom->getSequenceFromLocations(bed_file);
 
-	
-	shuffle();
+	shuffleWithCache(oChromIn, nIn, length, seed_in, cacheDir);
+}
+
+/**
+ * The repeats read are part of the key, wherever they were read from
+ */
+void ChromosomeReadTR::shuffleWithCache(ChromosomeOneDigit *oChromIn, int nIn,
+	int length, int seed_in, std::string cacheDir)
+{
+	if (cacheDir.empty())
+	{
+		shuffle();
+	}
+	else
+	{
+		std::vector<int> params = {nIn, length, seed_in};
+		ChromosomeTR::shuffleWithCache(cacheDir, hashInputs(oChromIn, "ChromosomeReadTR", params, readTRList));
+	}
+}
+
+void ChromosomeReadTR::writeState(std::ostream& out)
+{
+	writeInt(out, seed);
+	writeInt(out, TR_file_index);
+}
+
+bool ChromosomeReadTR::readState(std::istream& in)
+{
+	int seedIn, index;
+	if (!readInt(in, seedIn) || !readInt(in, index))
+	{
+		return false;
+	}
+	seed = seedIn;
+	TR_file_index = index;
+	return true;
 }
 
 ChromosomeReadTR::~ChromosomeReadTR()
@@ -61,8 +97,8 @@ void ChromosomeReadTR::shuffle()
 	for (int i = 0; i < getSegment()->size(); i++)
 	{
 
-		int start = getSegment()->at(i)->at(0);
-		int end = getSegment()->at(i)->at(1) + 1; // The end is inclusive
+		int start = getSegment()->getStart(i);
+		int end = getSegment()->getEnd(i) + 1; // The end is inclusive
 		std::string a = getBase()->substr(start, end - start);
 		int mutationSum = 0;
 		// Choose between minK and maxK every time
@@ -92,7 +128,7 @@ void ChromosomeReadTR::shuffle()
 				{
 					a.pop_back();
 				}
-				regionList->push_back(new Location(b.size() - trimmedTRSize + start - 1, b.size() + start - 1));
+				regionList->push_back(Region(b.size() - trimmedTRSize + start - 1, b.size() + start - 1));
 				seqLen += trimmedTRSize;
 				mutationSum += trimmedTRSize;
 			}
@@ -128,8 +164,8 @@ void ChromosomeReadTR::printBedData(std::string file, std::string chrom_name)
 	}
 	for (int i = 0; i < repeatList->size(); i++)
 	{
-		outSequence << chrom_name << "\t" << regionList->at(i)->getStart() << "\t" <<
-		regionList->at(i)->getEnd() << "\t" <<
+		outSequence << chrom_name << "\t" << regionList->at(i).start << "\t" <<
+		regionList->at(i).end << "\t" <<
 		Util::oneDigitToNuc(repeatList->at(i)) << std::endl;
 	}
 
@@ -11,8 +11,8 @@ namespace nonltr {
 	class ChromosomeReadTR : public ChromosomeTR {
 
 	public:
-		ChromosomeReadTR(int, ChromosomeOneDigit*, char, int, std::string, std::string, int seed_in = 0);
-		ChromosomeReadTR(int, ChromosomeOneDigit*, char, int, std::string, std::string, ChromosomeOneDigit *, int seed_in = 0);
+		ChromosomeReadTR(int, ChromosomeOneDigit*, char, int, std::string, std::string, int seed_in = 0, std::string cacheDir = "");
+		ChromosomeReadTR(int, ChromosomeOneDigit*, char, int, std::string, std::string, ChromosomeOneDigit *, int seed_in = 0, std::string cacheDir = "");
 		~ChromosomeReadTR();
 		void shuffle();
 		std::string getRandTR();
@@ -22,6 +22,10 @@ namespace nonltr {
 		int seed = 0;
 		int TR_file_index = 0;
 
+		void shuffleWithCache(ChromosomeOneDigit *, int, int, int, std::string);
+		void writeState(std::ostream&);
+		bool readState(std::istream&);
+
 	};
 
 
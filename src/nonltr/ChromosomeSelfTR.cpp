@@ -3,13 +3,16 @@
 #include <random>
 #include "../motif/FindMotif.h"
 #include "../mutate/HandleSeq.h"
+#include "../utility/CounterRandom.h"
 #include <random>
+#include <algorithm>
 #include <math.h>
 
 ChromosomeSelfTR::ChromosomeSelfTR(int nIn, ChromosomeOneDigit *oChromIn,
-	char unreadIn, int length, int minMotifIn, int maxMotifIn, int init_regIn, int seed_in) : ChromosomeTR(nIn, oChromIn, unreadIn, length, seed_in)
+	char unreadIn, int length, int minMotifIn, int maxMotifIn, int init_regIn, int seed_in,
+	std::string cacheDir) : ChromosomeTR(nIn, oChromIn, unreadIn, length, seed_in, cacheDir.empty())
 {
-	regionList = new std::vector<ILocation *>();
+	regionList = new std::vector<Region>();
 	repeatList = new std::vector<std::string>();
 	motifList = new std::vector<std::string>();
 	init_reg = init_regIn;
@@ -23,7 +26,15 @@ ChromosomeSelfTR::ChromosomeSelfTR(int nIn, ChromosomeOneDigit *oChromIn,
 	for(int i = 0; i < baseCountOChrom->size(); i++){
 		baseCountOChrom->at(i) = (baseCountOChrom->at(i) * 100) / sum;
 	}
-	shuffle();
+	if (cacheDir.empty())
+	{
+		shuffle();
+	}
+	else
+	{
+		std::vector<int> params = {nIn, length, minMotif, maxMotif, init_reg, seed_in};
+		shuffleWithCache(cacheDir, hashInputs(oChromIn, "ChromosomeSelfTR", params, NULL));
+	}
 }
 
 ChromosomeSelfTR::~ChromosomeSelfTR()
@@ -40,8 +51,8 @@ std::string ChromosomeSelfTR::getRandTR()
 	std::uniform_int_distribution<int> segmentGen(0, getSegment()->size() - 1);
 	int segmentChoice = segmentGen(generator);
 
-	int start = getSegment()->at(segmentChoice)->at(0);
-	int end = getSegment()->at(segmentChoice)->at(1) + 1;
+	int start = getSegment()->getStart(segmentChoice);
+	int end = getSegment()->getEnd(segmentChoice) + 1;
 
 	std::uniform_int_distribution<int> motifIndex(0, end - start - 1 - maxMotif);
 	std::uniform_int_distribution<int> exactRepeatDistr(init_reg, 20 * init_reg);
@@ -66,95 +77,152 @@ std::string ChromosomeSelfTR::getRandTR()
 	return newSubSeq;
 }
 
+namespace {
+	// The repeats planted in one segment, in order
+	struct SegmentRepeats {
+		std::vector<Region> regions;
+		std::vector<std::string> repeats;
+		std::vector<std::string> motifs;
+		int mutationSum = 0;
+	};
+}
+
+/**
+ * Plants mutated tandem repeats of motifs taken from the sequence itself.
+ * Bases between repeats are kept as they are, so only the repeats are
+ * written, in place. After a repeat, bases are kept until the repeats make
+ * up less than 5% of the segment so far; from then on each base starts a
+ * repeat with probability 1/21, so the gap is drawn at once. No repeat
+ * starts within 20 * init_reg bases of the end of a segment.
+ *
+ * Every segment draws from its own stream of the seed, so the segments are
+ * processed in parallel and the result depends on the seed only.
+ */
 void ChromosomeSelfTR::shuffle()
 {
-
-	std::default_random_engine generator(seed);
+	const SegmentList * segmentList = getSegment();
+	int segmentCount = segmentList->size();
+	std::vector<SegmentRepeats> found(segmentCount);
+	int streamSeed = seed;
 	seed++;
+	char * sequence = &(*rBase)[0];
 
-	std::uniform_int_distribution<int> exactRepeatDistr(init_reg, 20 * init_reg); // init_reg, 20 * init_reg
-	std::uniform_int_distribution<int> wordSizeDistr(minMotif, maxMotif);
-
-	int globalMutationSum = 0;
-	int numRepeats = 0;
-
-	for (int i = 0; i < getSegment()->size(); i++)
+	#pragma omp parallel for schedule(dynamic) num_threads(std::max(1, (int) Util::CORE_NUM))
+	for (int i = 0; i < segmentCount; i++)
 	{
-
-		int start = getSegment()->at(i)->at(0);
-		int end = getSegment()->at(i)->at(1) + 1; // The end is inclusive
-		std::string a = getBase()->substr(start, end - start);
+		CounterRandom generator(streamSeed, i);
+		std::uniform_int_distribution<int> exactRepeatDistr(init_reg, 20 * init_reg); // init_reg, 20 * init_reg
+		std::uniform_int_distribution<int> wordSizeDistr(minMotif, maxMotif);
+		std::uniform_int_distribution<int> rateDistr(0, 25);
+		std::geometric_distribution<int> gapDistr(1.0 / 21);
+		HandleSeq handleSeq(1, true);
+		SegmentRepeats& planted = found[i];
+
+		int start = segmentList->getStart(i);
+		int end = segmentList->getEnd(i) + 1; // The end is inclusive
+		int mutationRate = rateDistr(generator);
 		int mutationSum = 0;
-		// Choose between minK and maxK every time
-		int wordSize;
-		std::uniform_int_distribution<int> findPoint(0, 20);
-
-		std::reverse(a.begin(), a.end());
-		std::string b("");
-		for (int seqLen = 0; a.size() > 0;)
+		int seqLen = 0;
+		int p = start;
+		while (p < end)
 		{
-
-			if (a.size() > 20 * init_reg && double(mutationSum) / seqLen < 0.05 && findPoint(generator) == 0)
+			// Bases kept before the repeats drop below 5%
+			int kept = std::max(seqLen, std::max(1, 20 * mutationSum));
+			while (!(double(mutationSum) / kept < 0.05))
 			{
-				numRepeats++;
-
-				int exactLength = exactRepeatDistr(generator);
-				while (exactLength > a.size())
-				{
-					exactLength = exactRepeatDistr(generator);
-				}
-
-				wordSize = wordSizeDistr(generator);
-				if (exactLength / wordSize < 2)
-				{
-					std::uniform_int_distribution<int> newExactLengthDist(3, 20);
-					exactLength = wordSize * newExactLengthDist(generator);
-				}
-
-				int TRSize = (exactLength / wordSize) * wordSize;
-				std::string motif = a.substr(a.size() - wordSize, wordSize);
-				std::reverse(motif.begin(), motif.end());
-
-				motifList->push_back(motif);
-
-				std::string newSubSeq = motif::FindMotif::makeExact(motif, TRSize);
-
-				HandleSeq handleSeq(1, true);
+				kept++;
+			}
+			int next = p + (kept - seqLen) + gapDistr(generator);
+			if (end - next <= 20 * init_reg)
+			{
+				break;
+			}
+			seqLen += next - p;
+			p = next;
 
-				auto results = handleSeq.mutate(newSubSeq, mutationRate, baseCountOChrom);
-				newSubSeq = results.second;
-				newSubSeq = newSubSeq.substr(0, min(newSubSeq.size(), a.size()));
+			int remaining = end - p;
+			int exactLength = exactRepeatDistr(generator);
+			while (exactLength > remaining)
+			{
+				exactLength = exactRepeatDistr(generator);
+			}
 
-				mutationRate++;
-				mutationRate = max(mutationRate % 26, 0);
+			int wordSize = wordSizeDistr(generator);
+			if (exactLength / wordSize < 2)
+			{
+				std::uniform_int_distribution<int> newExactLengthDist(3, 20);
+				exactLength = wordSize * newExactLengthDist(generator);
+			}
 
-				TRSize = newSubSeq.size();
-				b += newSubSeq;
-				repeatList->push_back(newSubSeq);
+			int TRSize = (exactLength / wordSize) * wordSize;
+			std::string motif(sequence + p, wordSize);
+			std::string newSubSeq = motif::FindMotif::makeExact(motif, TRSize);
 
-				for (int j = 0; j < TRSize; j++)
-				{
-					a.pop_back();
-				}
-				regionList->push_back(new Location(b.size() - TRSize + start, b.size() + start));
-				seqLen += TRSize;
-				mutationSum += TRSize;
-			}
-			else
+			SingMute::seed(generator());
+			newSubSeq = handleSeq.mutate(newSubSeq, mutationRate, baseCountOChrom).second;
+			if (newSubSeq.size() > remaining)
 			{
-				char newChar = a.back();
-				a.pop_back();
-				b += newChar;
-				seqLen++;
+				newSubSeq.resize(remaining);
 			}
+			mutationRate = (mutationRate + 1) % 26;
+
+			TRSize = newSubSeq.size();
+			std::copy(newSubSeq.begin(), newSubSeq.end(), sequence + p);
+			planted.regions.push_back(Region(p, p + TRSize));
+			planted.repeats.push_back(newSubSeq);
+			planted.motifs.push_back(motif);
+			p += TRSize;
+			seqLen += TRSize;
+			mutationSum += TRSize;
 		}
-		replaceSeq(b, start, start + b.size());
-		globalMutationSum += mutationSum;
+		planted.mutationSum = mutationSum;
+	}
+
+	int globalMutationSum = 0;
+	int numRepeats = 0;
+	for (int i = 0; i < segmentCount; i++)
+	{
+		SegmentRepeats& planted = found[i];
+		regionList->insert(regionList->end(), planted.regions.begin(), planted.regions.end());
+		repeatList->insert(repeatList->end(), planted.repeats.begin(), planted.repeats.end());
+		motifList->insert(motifList->end(), planted.motifs.begin(), planted.motifs.end());
+		globalMutationSum += planted.mutationSum;
+		numRepeats += planted.repeats.size();
 	}
 	setK(ceil(log(globalMutationSum / (double)numRepeats) / log(4)) - 1);
 }
 
 
+void ChromosomeSelfTR::writeState(std::ostream& out)
+{
+	writeInt(out, mutationRate);
+	writeInt(out, motifList->size());
+	for (const std::string& motif : *motifList)
+	{
+		writeString(out, motif);
+	}
+}
+
+bool ChromosomeSelfTR::readState(std::istream& in)
+{
+	int rate, motifCount;
+	if (!readInt(in, rate) || !readInt(in, motifCount) || motifCount < 0)
+	{
+		return false;
+	}
+	std::vector<std::string> motifs(motifCount);
+	for (int i = 0; i < motifCount; i++)
+	{
+		if (!readString(in, motifs[i]))
+		{
+			return false;
+		}
+	}
+	mutationRate = rate;
+	motifList->insert(motifList->end(), motifs.begin(), motifs.end());
+	return true;
+}
+
 void ChromosomeSelfTR::printBedData(std::string file, std::string chr)
 {
 	ofstream outSequence;
@@ -168,8 +236,8 @@ void ChromosomeSelfTR::printBedData(std::string file, std::string chr)
 	outSequence << "Start\tEnd\tMotif\tMutationRate\tTR" << std::endl;
 	for (int i = 0; i < motifList->size(); i++)
 	{
-		outSequence << chr << "\t" << regionList->at(i)->getStart() << "\t" <<
-		regionList->at(i)->getEnd() << "\t" <<
+		outSequence << chr << "\t" << regionList->at(i).start << "\t" <<
+		regionList->at(i).end << "\t" <<
 		Util::oneDigitToNuc(motifList->at(i)) << "\t" << i % 25 << "\t" <<
 		Util::oneDigitToNuc(repeatList->at(i)) << std::endl;
 	}
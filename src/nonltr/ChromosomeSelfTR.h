@@ -11,7 +11,7 @@ namespace nonltr {
 	class ChromosomeSelfTR : public ChromosomeTR {
 
 	public:
-		ChromosomeSelfTR(int, ChromosomeOneDigit*, char, int, int, int, int, int seed_in = 0);
+		ChromosomeSelfTR(int, ChromosomeOneDigit*, char, int, int, int, int, int seed_in = 0, std::string cacheDir = "");
 		~ChromosomeSelfTR();
 		void shuffle();
 		std::string getRandTR();
@@ -22,6 +22,9 @@ namespace nonltr {
 		int minMotif, maxMotif;
 		int mutationRate = 0;
 
+		void writeState(std::ostream&);
+		bool readState(std::istream&);
+
 	};
 
 
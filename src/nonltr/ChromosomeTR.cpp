@@ -5,11 +5,47 @@
 #include "../mutate/HandleSeq.h"
 #include <random>
 #include <math.h>
+#include <stdio.h>
+#include <string.h>
+#include <unistd.h>
 
+namespace {
+	// Starts every cache file; changes whenever its layout does
+	const char CACHE_MAGIC[8] = {'L', '4', 'T', 'R', 'C', 'T', 'R', '1'};
+
+	// FNV-1a
+	uint64_t hashBytes(uint64_t h, const void * bytes, size_t size)
+	{
+		const unsigned char * b = (const unsigned char *) bytes;
+		for (size_t i = 0; i < size; i++)
+		{
+			h = (h ^ b[i]) * 0x100000001B3ULL;
+		}
+		return h;
+	}
+
+	uint64_t hashInt(uint64_t h, int value)
+	{
+		return hashBytes(h, &value, sizeof(value));
+	}
+
+	uint64_t hashString(uint64_t h, const std::string& text)
+	{
+		h = hashInt(h, text.size());
+		return hashBytes(h, text.data(), text.size());
+	}
+}
+
+/**
+ * Without isGenerated the random sequence is not made here; the subclass
+ * either loads it with its repeats from the cache or generates it before
+ * shuffling.
+ */
 ChromosomeTR::ChromosomeTR(int nIn, ChromosomeOneDigit *oChromIn,
-	char unreadIn, int length, int seed_in) : ChromosomeRandom(nIn, oChromIn, unreadIn, length)
+	char unreadIn, int length, int seed_in, bool isGenerated) : ChromosomeRandom(nIn, oChromIn, unreadIn, length, isGenerated)
 {
-	regionList = new std::vector<ILocation *>();
+	seed = seed_in;
+	regionList = new std::vector<Region>();
 	repeatList = new std::vector<std::string>();
 	baseCountOChrom = oChromIn->getBaseCount();
 	int sum = 0;
@@ -22,7 +58,6 @@ ChromosomeTR::ChromosomeTR(int nIn, ChromosomeOneDigit *oChromIn,
 }
 
 ChromosomeTR::~ChromosomeTR(){
-	Util::deleteInVector(regionList);
 	delete repeatList;
 	delete regionList;
 }
@@ -151,7 +186,7 @@ int ChromosomeTR::size()
 	return rBase->size();
 }
 
-std::vector<ILocation *> *ChromosomeTR::getRegionList()
+std::vector<Region> *ChromosomeTR::getRegionList()
 {
 	return regionList;
 }
@@ -160,3 +195,197 @@ std::vector<std::string> *ChromosomeTR::getRepeatList()
 {
 	return repeatList;
 }
+
+/**
+ * The synthetic chromosome is fully determined by the original chromosome,
+ * the base counts it is mutated with, the kind of chromosome, its numeric
+ * parameters and, for chromosomes made of read repeats, those repeats.
+ */
+uint64_t ChromosomeTR::hashInputs(ChromosomeOneDigit * oChromIn, const std::string& kind,
+	const std::vector<int>& params, const std::vector<std::string> * texts)
+{
+	uint64_t h = 0xCBF29CE484222325ULL;
+	h = hashBytes(h, CACHE_MAGIC, sizeof(CACHE_MAGIC));
+	h = hashString(h, kind);
+	h = hashInt(h, params.size());
+	for (int param : params)
+	{
+		h = hashInt(h, param);
+	}
+	h = hashString(h, *oChromIn->getBase());
+	const SegmentList * segmentList = oChromIn->getSegment();
+	h = hashInt(h, segmentList->size());
+	h = hashBytes(h, segmentList->getStarts().data(), segmentList->size() * sizeof(int));
+	h = hashBytes(h, segmentList->getEnds().data(), segmentList->size() * sizeof(int));
+	std::vector<int> * baseCount = oChromIn->getBaseCount();
+	h = hashInt(h, baseCount->size());
+	for (int count : *baseCount)
+	{
+		h = hashInt(h, count);
+	}
+	if (texts != NULL)
+	{
+		h = hashInt(h, texts->size());
+		for (const std::string& text : *texts)
+		{
+			h = hashString(h, text);
+		}
+	}
+	return h;
+}
+
+/**
+ * Reloads the sequence and the planted repeats stored under key in cacheDir.
+ * If there are none, the random sequence is generated, shuffled and stored.
+ */
+void ChromosomeTR::shuffleWithCache(const std::string& cacheDir, uint64_t key)
+{
+	char name[17];
+	snprintf(name, sizeof(name), "%016llx", (unsigned long long) key);
+	std::string file = cacheDir + "/ChromosomeTR-" + name + ".bin";
+
+	if (readCache(file, key))
+	{
+		std::cout << "Read the synthetic chromosome from " << file << std::endl;
+		return;
+	}
+	generate();
+	shuffle();
+	writeCache(file, key);
+}
+
+/**
+ * Nothing is changed unless the whole file is read
+ */
+bool ChromosomeTR::readCache(const std::string& file, uint64_t key)
+{
+	std::ifstream in(file.c_str(), std::ios::in | std::ios::binary);
+	if (!in.is_open())
+	{
+		return false;
+	}
+
+	char magic[sizeof(CACHE_MAGIC)];
+	uint64_t fileKey;
+	if (!in.read(magic, sizeof(magic)) || memcmp(magic, CACHE_MAGIC, sizeof(magic)) != 0
+		|| !in.read((char *) &fileKey, sizeof(fileKey)) || fileKey != key)
+	{
+		return false;
+	}
+
+	int k, seedIn, regionCount, repeatCount;
+	std::string base;
+	if (!readInt(in, k) || !readInt(in, seedIn) || !readString(in, base)
+		|| base.size() != rBase->size() || !readInt(in, regionCount) || regionCount < 0)
+	{
+		return false;
+	}
+	std::vector<Region> regions(regionCount);
+	for (Region& region : regions)
+	{
+		if (!readInt(in, region.start) || !readInt(in, region.end)
+			|| region.start < 0 || region.start > region.end)
+		{
+			return false;
+		}
+	}
+	if (!readInt(in, repeatCount) || repeatCount < 0)
+	{
+		return false;
+	}
+	std::vector<std::string> repeats(repeatCount);
+	for (int i = 0; i < repeatCount; i++)
+	{
+		if (!readString(in, repeats[i]))
+		{
+			return false;
+		}
+	}
+	if (!readState(in))
+	{
+		return false;
+	}
+
+	rBase->swap(base);
+	regionList->insert(regionList->end(), regions.begin(), regions.end());
+	repeatList->insert(repeatList->end(), repeats.begin(), repeats.end());
+	K = k;
+	seed = seedIn;
+	return true;
+}
+
+/**
+ * The file is written under a temporary name and renamed, so a reader never
+ * sees a partial one
+ */
+void ChromosomeTR::writeCache(const std::string& file, uint64_t key)
+{
+	std::string temp = file + "." + Util::int2string(getpid()) + ".tmp";
+	std::ofstream out(temp.c_str(), std::ios::out | std::ios::binary);
+	if (out.is_open())
+	{
+		out.write(CACHE_MAGIC, sizeof(CACHE_MAGIC));
+		out.write((const char *) &key, sizeof(key));
+		writeInt(out, K);
+		writeInt(out, seed);
+		writeString(out, *rBase);
+		writeInt(out, regionList->size());
+		for (const Region& region : *regionList)
+		{
+			writeInt(out, region.start);
+			writeInt(out, region.end);
+		}
+		writeInt(out, repeatList->size());
+		for (const std::string& repeat : *repeatList)
+		{
+			writeString(out, repeat);
+		}
+		writeState(out);
+		out.close();
+	}
+	if (!out || rename(temp.c_str(), file.c_str()) != 0)
+	{
+		remove(temp.c_str());
+		std::cerr << "Cannot write the cache file " << file << std::endl;
+	}
+}
+
+/**
+ * What a subclass needs besides the sequence and the repeats to continue
+ * as if it had just shuffled
+ */
+void ChromosomeTR::writeState(std::ostream& out)
+{
+}
+
+bool ChromosomeTR::readState(std::istream& in)
+{
+	return true;
+}
+
+void ChromosomeTR::writeInt(std::ostream& out, int value)
+{
+	out.write((const char *) &value, sizeof(value));
+}
+
+bool ChromosomeTR::readInt(std::istream& in, int& value)
+{
+	return (bool) in.read((char *) &value, sizeof(value));
+}
+
+void ChromosomeTR::writeString(std::ostream& out, const std::string& text)
+{
+	writeInt(out, text.size());
+	out.write(text.data(), text.size());
+}
+
+bool ChromosomeTR::readString(std::istream& in, std::string& text)
+{
+	int size;
+	if (!readInt(in, size) || size < 0)
+	{
+		return false;
+	}
+	text.resize(size);
+	return size == 0 || (bool) in.read(&text[0], size);
+}
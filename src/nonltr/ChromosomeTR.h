@@ -3,7 +3,10 @@
 
 #include <string>
 #include <random>
+#include <iostream>
+#include <stdint.h>
 #include "../utility/Location.h"
+#include "../utility/Region.h"
 #include "ChromosomeRandom.h"
 
 namespace nonltr {
@@ -11,7 +14,7 @@ namespace nonltr {
 	class ChromosomeTR : public ChromosomeRandom {
 
 	public:
-		ChromosomeTR(int, ChromosomeOneDigit *, char, int, int);
+		ChromosomeTR(int, ChromosomeOneDigit *, char, int, int, bool = true);
 		virtual ~ChromosomeTR();
 		void removeLocations(const std::vector<Location *> *);
 		virtual void replaceSeq(std::string&, Location&);
@@ -24,16 +27,31 @@ namespace nonltr {
 		void setK(int);
 		int getK();
 		virtual void printBedData(std::string, std::string chr = "") = 0;
-		std::vector<ILocation *> * getRegionList();
+		std::vector<Region> * getRegionList();
 		std::vector<std::string> * getRepeatList();
 	protected:
-		std::vector<ILocation *> * regionList;
+		std::vector<Region> * regionList;
 		std::vector<std::string> * repeatList;
 		std::vector<std::string> * readTRList;
 		std::vector<int> * baseCountOChrom;
 		int K;
 		int seed = 0;
 
+		void shuffleWithCache(const std::string&, uint64_t);
+		static uint64_t hashInputs(ChromosomeOneDigit *, const std::string&,
+			const std::vector<int>&, const std::vector<std::string> *);
+		virtual void writeState(std::ostream&);
+		virtual bool readState(std::istream&);
+
+		static void writeInt(std::ostream&, int);
+		static bool readInt(std::istream&, int&);
+		static void writeString(std::ostream&, const std::string&);
+		static bool readString(std::istream&, std::string&);
+
+	private:
+		bool readCache(const std::string&, uint64_t);
+		void writeCache(const std::string&, uint64_t);
+
 	};
 
 
@@ -175,8 +175,8 @@ HMM::~HMM() {
 }
 
 void HMM::train(vector<int> * scoreListIn,
-		const vector<vector<int> *> * segmentListIn,
-		const vector<ILocation*> * candidateListIn) {
+		const SegmentList * segmentListIn,
+		const vector<Region> * candidateListIn) {
 
 	scoreList = scoreListIn;
 	segmentList = segmentListIn;
@@ -188,14 +188,13 @@ void HMM::train(vector<int> * scoreListIn,
 		int lastCandIndex = 0;
 		int segmentNumber = segmentList->size();
 		for (int i = 0; i < segmentNumber; i++) {
-			vector<int> * s = segmentList->at(i);
-			ILocation * c = candidateList->at(firstCandIndex);
+			int segStart = segmentList->getStart(i);
+			int segEnd = segmentList->getEnd(i);
+			const Region& c = candidateList->at(firstCandIndex);
 			// A segment may have no detections
-			if (Util::isOverlapping(s->at(0), s->at(1), c->getStart(),
-					c->getEnd())) {
-				lastCandIndex = trainHelper1(s->at(0), s->at(1),
-						firstCandIndex);
-				trainHelper2(s->at(0), s->at(1), firstCandIndex, lastCandIndex);
+			if (Util::isOverlapping(segStart, segEnd, c.start, c.end)) {
+				lastCandIndex = trainHelper1(segStart, segEnd, firstCandIndex);
+				trainHelper2(segStart, segEnd, firstCandIndex, lastCandIndex);
 				firstCandIndex = lastCandIndex + 1;
 				if (firstCandIndex >= candidateCount) {
 					break;
@@ -208,12 +207,11 @@ void HMM::train(vector<int> * scoreListIn,
 
 int HMM::trainHelper1(int segStart, int segEnd, int firstCandIndex) {
 
-	ILocation * cand = candidateList->at(firstCandIndex);
-	if (!Util::isOverlapping(segStart, segEnd, cand->getStart(),
-			cand->getEnd())) {
+	const Region& cand = candidateList->at(firstCandIndex);
+	if (!Util::isOverlapping(segStart, segEnd, cand.start, cand.end)) {
 		string msg("The first candidate is not overlapping with the segment. ");
 		msg.append("Candidate location is: ");
-		msg.append(cand->toString());
+		msg.append(cand.toString());
 		msg.append(" Segment location is: ");
 		msg.append(Util::int2string(segStart));
 		msg.append("-");
@@ -224,9 +222,8 @@ int HMM::trainHelper1(int segStart, int segEnd, int firstCandIndex) {
 	int lastCandIndex = -1;
 	int candidateNumber = candidateList->size();
 	for (int c = firstCandIndex; c < candidateNumber; c++) {
-		ILocation * cand = candidateList->at(c);
-		if (Util::isOverlapping(segStart, segEnd, cand->getStart(),
-				cand->getEnd())) {
+		const Region& cand = candidateList->at(c);
+		if (Util::isOverlapping(segStart, segEnd, cand.start, cand.end)) {
 			lastCandIndex = c;
 		} else {
 			break;
@@ -244,10 +241,8 @@ int HMM::trainHelper1(int segStart, int segEnd, int firstCandIndex) {
 void HMM::trainHelper2(int segStart, int segEnd, int firstCandIndex,
 		int lastCandIndex) {
 
-	ILocation * f = candidateList->at(firstCandIndex);
-
 	// First negative region if present
-	int fStart = f->getStart();
+	int fStart = candidateList->at(firstCandIndex).start;
 	if (fStart > segStart) {
 		trainNegative(segStart, fStart - 1);
 
@@ -256,22 +251,21 @@ void HMM::trainHelper2(int segStart, int segEnd, int firstCandIndex,
 
 	// Alternating positive and negative regions
 	for (int i = firstCandIndex; i < lastCandIndex; i++) {
-		ILocation * c = candidateList->at(i);
-		int cStart = c->getStart();
-		int cEnd = c->getEnd();
+		int cStart = candidateList->at(i).start;
+		int cEnd = candidateList->at(i).end;
 		trainPositive(cStart, cEnd);
 
 		move(getPstvState(cEnd), getNgtvState(cEnd + 1));
 
-		int nextStart = candidateList->at(i + 1)->getStart();
+		int nextStart = candidateList->at(i + 1).start;
 		trainNegative(cEnd + 1, nextStart - 1);
 		move(getNgtvState(nextStart - 1), getPstvState(nextStart));
 	}
 
 	// Last positive region
-	ILocation * l = candidateList->at(lastCandIndex);
-	int lEnd = l->getEnd();
-	trainPositive(l->getStart(), lEnd);
+	const Region& l = candidateList->at(lastCandIndex);
+	int lEnd = l.end;
+	trainPositive(l.start, lEnd);
 
 	// Last negative region if present
 	if (segEnd > lEnd) {
@@ -537,7 +531,7 @@ double HMM::decode(int rStart, int rEnd, vector<int> * scoreListIn,
  * Append positive regions at the end of regionList
  */
 double HMM::decode(int rStart, int rEnd, vector<int> * scoreListIn,
-		vector<ILocation *>& regionList) {
+		vector<Region>& regionList) {
 
 	vector<int> stateList;
 	double logLikelihood = decode(rStart, rEnd, scoreListIn, stateList);
@@ -568,7 +562,7 @@ double HMM::decode(int rStart, int rEnd, vector<int> * scoreListIn,
 		}
 		// Extract features of the just recognized repeat
 		if (canFill) {
-			regionList.push_back(new Location(s + rStart, e + rStart));
+			regionList.push_back(Region(s + rStart, e + rStart));
 			s = -1;
 			e = -1;
 			canFill = false;
@@ -582,7 +576,7 @@ double HMM::decode(int rStart, int rEnd, vector<int> * scoreListIn,
  * Append positive regions at the end of regionList
  */
 double HMM::decodeNew(int rStart, int rEnd, vector<int> * scoreListIn,
-		vector<ILocation *>& regionList) {
+		vector<Region>& regionList) {
 
 	vector<int> stateList;
 	double logLikelihood = decodeNew(rStart, rEnd, scoreListIn, stateList);
@@ -613,7 +607,7 @@ double HMM::decodeNew(int rStart, int rEnd, vector<int> * scoreListIn,
 		}
 		// Extract features of the just recognized repeat
 		if (canFill) {
-			regionList.push_back(new Location(s + rStart, e + rStart));
+			regionList.push_back(Region(s + rStart, e + rStart));
 			s = -1;
 			e = -1;
 			canFill = false;
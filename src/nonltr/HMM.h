@@ -14,7 +14,8 @@
 #include <stdlib.h>
 #include <iostream>
 
-#include "../utility/ILocation.h"
+#include "../utility/Region.h"
+#include "SegmentList.h"
 
 using namespace std;
 using namespace utility;
@@ -60,8 +61,8 @@ protected:
 	int positiveStateNumber;
 
 	vector<int> * scoreList;
-	const vector<vector<int> *> * segmentList;
-	const vector<ILocation*> * candidateList;
+	const SegmentList * segmentList;
+	const vector<Region> * candidateList;
 
 	void initialize(int);
 	/**
@@ -76,13 +77,13 @@ public:
 	HMM(int);
 	HMM(HMM&);
 	virtual ~HMM();
-	void train(vector<int> *, const vector<vector<int> *> *,
-			const vector<ILocation*> *);
+	void train(vector<int> *, const SegmentList *,
+			const vector<Region> *);
 	void normalize();
 	double decode(int, int, vector<int> *, vector<int>&);
-	double decode(int, int, vector<int> *, vector<ILocation *>&);
+	double decode(int, int, vector<int> *, vector<Region>&);
 	double decodeNew(int, int, vector<int> *, vector<int>&);
-	double decodeNew(int, int, vector<int> *, vector<ILocation *>&);
+	double decodeNew(int, int, vector<int> *, vector<Region>&);
 
 	void print();
 	void print(string);
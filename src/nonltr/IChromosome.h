@@ -11,6 +11,8 @@
 #include <string>
 #include <vector>
 
+#include "SegmentList.h"
+
 using namespace std;
 
 namespace nonltr {
@@ -18,7 +20,7 @@ namespace nonltr {
 class IChromosome {
 public:
 	virtual const string* getBase() = 0;
-	virtual const vector<vector<int> *> * getSegment() = 0;
+	virtual const SegmentList * getSegment() = 0;
 	virtual string getHeader() = 0;
 };
 
@@ -0,0 +1,97 @@
+/*
+ * SegmentList.h
+ *
+ * The segments of a chromosome, kept as two parallel arrays of start and
+ * end coordinates. Coordinates are inclusive [s,e] and the segments are
+ * sorted and do not overlap.
+ */
+
+#ifndef SEGMENTLIST_H_
+#define SEGMENTLIST_H_
+
+#include <vector>
+#include <algorithm>
+
+using namespace std;
+
+namespace nonltr {
+
+class SegmentList {
+private:
+	vector<int> starts;
+	vector<int> ends;
+
+public:
+	int size() const {
+		return starts.size();
+	}
+
+	bool empty() const {
+		return starts.empty();
+	}
+
+	int getStart(int i) const {
+		return starts[i];
+	}
+
+	int getEnd(int i) const {
+		return ends[i];
+	}
+
+	int getLength(int i) const {
+		return ends[i] - starts[i] + 1;
+	}
+
+	void setEnd(int i, int e) {
+		ends[i] = e;
+	}
+
+	/**
+	 * All starts and all ends, indexed like the segments
+	 */
+	const vector<int>& getStarts() const {
+		return starts;
+	}
+
+	const vector<int>& getEnds() const {
+		return ends;
+	}
+
+	void add(int s, int e) {
+		starts.push_back(s);
+		ends.push_back(e);
+	}
+
+	void reserve(int n) {
+		starts.reserve(n);
+		ends.reserve(n);
+	}
+
+	void clear() {
+		starts.clear();
+		ends.clear();
+	}
+
+	void swap(SegmentList& other) {
+		starts.swap(other.starts);
+		ends.swap(other.ends);
+	}
+
+	/**
+	 * Maps the segments onto the other strand of a sequence whose last
+	 * index is lastBase, keeping them sorted
+	 */
+	void reverse(int lastBase) {
+		int segNum = size();
+		for (int i = 0; i < segNum; i++) {
+			int s = lastBase - ends[i];
+			ends[i] = lastBase - starts[i];
+			starts[i] = s;
+		}
+		std::reverse(starts.begin(), starts.end());
+		std::reverse(ends.begin(), ends.end());
+	}
+};
+
+} /* namespace nonltr */
+#endif /* SEGMENTLIST_H_ */
@@ -12,7 +12,6 @@ namespace satellites {
 	IClient(hmm, compList, minK, maxK, halfW, base) {
 
 		chromList = chromListIn;
-		hmm_sats = new vector<vector<ILocation*>*>();
 		idn = idnIn;
 		smoothingWindow = smoothingWindowIn;
 		mtf = mtfIn;
@@ -22,19 +21,13 @@ namespace satellites {
 	}
 
 	Client_Scanner::~Client_Scanner() {
-		for (auto satList : *hmm_sats) {
-			Util::deleteInVector(satList);
-		}
-		Util::deleteInVector(hmm_sats);
-		hmm_sats->clear();
-		delete hmm_sats;
 	}
 
 /**
  * This method uses the HMM to detect satellites
  */
 	void Client_Scanner::get_hmm_sats(
-		vector<tuple<ILocation*, ChromosomeOneDigit *, string, string, double> >& output) {
+		vector<tuple<Region, ChromosomeOneDigit *, string, string, double> >& output) {
 		for (int i = 0; i < chromList->size(); i++) {
 
 		// Score the chromosome
@@ -42,39 +35,37 @@ namespace satellites {
 			vector<char> * bestKList = scorer->getBestKList();
 
 		// Find STR using the HMM
-			vector<ILocation*> * chromSats = new vector<ILocation*>();
-			decode(chromList->at(i), scorer, chromSats);
-
-			hmm_sats->push_back(chromSats);
+			vector<Region> chromSats;
+			decode(chromList->at(i), scorer, &chromSats);
 
 		// Collect the results from the cores
-			vector<tuple<ILocation*, ChromosomeOneDigit *, string, string, double>> coreCollect(
-				chromSats->size());
+			vector<tuple<Region, ChromosomeOneDigit *, string, string, double>> coreCollect(
+				chromSats.size());
 
 		// Find the repeated motif in this STR
-			for (int j = 0; j < chromSats->size(); j++) {
-				auto sat = chromSats->at(j);
+			for (int j = 0; j < chromSats.size(); j++) {
+				Region& sat = chromSats.at(j);
 
 			// Extend the end
-				int bestK = bestKList->at(sat->getEnd());
+				int bestK = bestKList->at(sat.end);
 				if (bestK < 0) {
 					cerr << "Client_Scanner::get_hmm_sats - ";
 					cerr << "the extension amount cannot be negative";
 					cerr << endl;
 					throw std::exception();
 				} else if (bestK > 0 ) {
-					sat->setEnd(sat->getEnd() + bestK - 1);
+					sat.end += bestK - 1;
 				}
 				
 			// Convert digits to nucleotides
 				string candidate = oneDigitToNucleotide(chromList->at(i)->getBase(),
-					sat->getStart(), sat->getLength());
+					sat.start, sat.getLength());
 
 			// Without the following condition the motif discovery module
 			// will fail when the region is smaller than twice the smoothing
 			// window
-				if (sat->getLength() > 2 * smoothingWindow
-					&& sat->getLength() > (minReg / 2.0)) {
+				if (sat.getLength() > 2 * smoothingWindow
+					&& sat.getLength() > (minReg / 2.0)) {
 					if (mtf) {
 						FindMotif * findMotif;
 						string candidateSample;
@@ -82,7 +73,12 @@ namespace satellites {
 						candidateSample = candidate.substr(0, 5000);
 
 					// We search for a micro region
-						findMotif = new FindMotif(candidateSample, idn, pred);
+						// Clean microsatellites only need words of their period
+						vector<int> periods = FindMotif::findPeriods(
+							chromList->at(i)->getBase(), sat.start,
+							candidateSample.size());
+						findMotif = new FindMotif(candidateSample, idn, pred, mtf == 2,
+							periods);
 						
 
 						if (findMotif->getIsFound()) {
@@ -128,23 +124,24 @@ namespace satellites {
  * Parameter chromSats: is a list of the found satellites
  */
 	void Client_Scanner::decode(ChromosomeOneDigit * chrom, ScorerSat * scorer,
-		vector<ILocation*>* chromSats) {
+		vector<Region>* chromSats) {
 
 		auto segmentList = chrom->getSegment();
+		// The regions before this index are merged already; only those
+		// decoded since are merged into them
+		int mergedCount = 0;
 		for (int i = 0; i < segmentList->size(); i++) {
-			std:;vector<ILocation *> mergingChromSats;
-
-			auto segment = segmentList->at(i);
-			int segStart = segment->at(0);
-			int segEnd = segment->at(1);
-
-			hmm->decode(segStart, segEnd, scorer->getFlatScores(), mergingChromSats);
+			int segStart = segmentList->getStart(i);
+			int segEnd = segmentList->getEnd(i);
 
+			// The regions of a segment are merged with the earlier ones
+			// before the next segment is decoded
 			if(will_merge){
-				Util::merge(chromSats, minReg);
+				Util::merge(chromSats, minReg, mergedCount);
+				mergedCount = chromSats->size();
 			}
 
-			chromSats->insert(std::end(*chromSats), std::begin(mergingChromSats), std::end(mergingChromSats));
+			hmm->decode(segStart, segEnd, scorer->getFlatScores(), *chromSats);
 		}
 	}
 
@@ -7,7 +7,7 @@
 #include "IClient.h"
 #include "../motif/FindMotif.h"
 #include "../satellites/ScorerSat.h"
-#include "../utility/ILocation.h"
+#include "../utility/Region.h"
 #include "../train/Predictor.h"
 
 using namespace std;
@@ -19,7 +19,6 @@ class Client_Scanner: public IClient {
 
 private:
 	const vector<ChromosomeOneDigit*>* chromList;
-	vector<vector<ILocation*>*> * hmm_sats;
 	string oneDigitToNucleotide(const string *, int, int);
 
 	// The identify score used by the motif discovery module and filtering
@@ -34,7 +33,7 @@ private:
 	int minReg;
 	int will_merge;
 
-	void decode(ChromosomeOneDigit *, ScorerSat *, vector<ILocation*>*);
+	void decode(ChromosomeOneDigit *, ScorerSat *, vector<Region>*);
 
 public:
 	Client_Scanner(const vector<ChromosomeOneDigit*>*, HMM*, vector<double>&,
@@ -43,7 +42,7 @@ public:
 
 	void get_hmm_sats(
 			vector<
-					tuple<ILocation*, ChromosomeOneDigit *, string, string,
+					tuple<Region, ChromosomeOneDigit *, string, string,
 							double> >&);
 };
 }
@@ -38,7 +38,6 @@ namespace satellites {
   }
   
   Client_Trainer::~Client_Trainer() {
-    Util::deleteInVector(chromSats);
     delete chromSats;
     delete train_scorer;
     delete test_scorer;
@@ -57,25 +56,25 @@ namespace satellites {
     hmm->normalize();
     
     
-    chromSats = new vector<ILocation*>;
+    chromSats = new vector<Region>;
     decode(testChrom, test_scorer, chromSats);
     
     
     
     vector<char> * bestKList = test_scorer->getBestKList();
     for (int j = 0; j < chromSats->size(); j++) {
-      auto sat = chromSats->at(j);
+      Region& sat = chromSats->at(j);
       
       // Extend the end
-      int bestK = bestKList->at(sat->getEnd());
+      int bestK = bestKList->at(sat.end);
       if (bestK < 0) {
-       std::cout << sat->toString() << std::endl;
-       for(int k = sat->getStart(); k < sat->getEnd(); k++){
+       std::cout << sat.toString() << std::endl;
+       for(int k = sat.start; k < sat.end; k++){
          std::cout << bestKList->at(k) << " ";
        }
        std::cout << std::endl;
 
-       std::string sstring = testChrom->getSubStr(sat->getStart(), sat->getEnd());
+       std::string sstring = testChrom->getSubStr(sat.start, sat.end);
        for(auto it = sstring.begin(); it != sstring.end(); it++){
          std::cout << (int) *it << " ";
        }
@@ -86,36 +85,67 @@ namespace satellites {
        cerr << endl;
        throw std::exception();
      } else if (bestK > 0){
-       sat->setEnd(sat->getEnd() + bestK - 1);
+       sat.end += bestK - 1;
      }
    }
    Util::merge(chromSats);
 
+   Util::overlapLengths(chromSats, testChrom->getRegionList(), truePositive,
+     falsePositive, falseNegative);
  }
 
 
+ /**
+  * Labeling training pairs by alignment dominates predictor training, so the
+  * repeats are searched in parallel batches. Each repeat keeps its own pairs,
+  * which are handed to the predictor in repeat order; the predictor is then
+  * fit once, on the same pairs a serial run would have collected.
+  */
  void Client_Trainer::trainPredictor(Predictor<int> * pred, int threshold){
+  const int threadNum = std::max(1, (int) Util::CORE_NUM);
+  const int batchSize = 4 * threadNum;
+  bool isFull = false;
 
+  pred->begin_collect(threadNum);
   std::vector<std::string> * repeatList = testChrom->getRepeatList();
-  for(int i = 0; i < repeatList->size(); i++){
-    motif::FindMotif * f = new motif::FindMotif(repeatList->at(i), threshold, pred);
+  for(int i = 0; i < repeatList->size() && !isFull; i += batchSize){
+    int end = std::min((int) repeatList->size(), i + batchSize);
+    std::vector<std::string> batch(repeatList->begin() + i, repeatList->begin() + end);
+    isFull = collectPairs(pred, batch, threshold);
+  }
+  while(!isFull){
+    std::vector<std::string> batch;
+    for(int i = 0; i < batchSize; i++){
+      std::string artificalRepeat = testChrom->getRandTR();
+      std:: cout << artificalRepeat << std::endl;
+      batch.push_back(artificalRepeat);
+    }
+    isFull = collectPairs(pred, batch, threshold);
+  }
+  pred->end_collect();
+}
+
+bool Client_Trainer::collectPairs(Predictor<int> * pred, std::vector<std::string>& batch, int threshold){
+  std::vector<std::vector<pra<int> > > pairList(batch.size());
+
+  #pragma omp parallel for schedule(dynamic) num_threads(std::max(1, (int) Util::CORE_NUM))
+  for(int i = 0; i < batch.size(); i++){
+    pred->collect_into(&pairList.at(i));
+    motif::FindMotif * f = new motif::FindMotif(batch.at(i), threshold, pred);
     delete f;
-    if(pred->get_is_trained()){
-     return;
-   }
+    pred->collect_into(NULL);
+  }
 
- }
- while(!pred->get_is_trained()){
-  std::string artificalRepeat = testChrom->getRandTR();
-  std:: cout << artificalRepeat << std::endl;
-  motif::FindMotif * f = new motif::FindMotif(artificalRepeat, threshold, pred);
-  delete f;
-}
+  bool isFull = false;
+  for(int i = 0; i < pairList.size(); i++){
+    isFull = pred->add_collected(pairList.at(i));
+  }
+  return isFull;
 }
 
 
 
-vector<ILocation*>* Client_Trainer::getChromSats(){
+vector<Region>* Client_Trainer::getChromSats(){
   return chromSats;
 }
 
@@ -125,11 +155,8 @@ vector<ILocation*>* Client_Trainer::getChromSats(){
     The returns the precision obtain from training. Precision is TP / GT.
   */
 double Client_Trainer::getSensitivity(){
-
-  std::vector<Location *> * intersection = Util::locationIntersect(chromSats, testChrom->getRegionList());
-
-  double TP = Util::sumTotalLength(intersection);
-  double GT = Util::sumTotalLength(testChrom->getRegionList());
+  double TP = truePositive;
+  double GT = truePositive + falseNegative;
 
   double sens = 0;
   if(GT == 0){
@@ -137,9 +164,6 @@ double Client_Trainer::getSensitivity(){
   } else {
     sens = TP / GT;
   }
-
-  Util::deleteInVector(intersection);
-  delete intersection;
   return sens;
 }
 
@@ -147,16 +171,8 @@ double Client_Trainer::getSensitivity(){
     The returns the sensitivity obtain from training. Sensitivity is TP / (TP + FP).
   */
 double Client_Trainer::getPrecision(){
-
-
-  std::vector<Location *> * subtraction = Util::locationSubtract(chromSats, testChrom->getRegionList());
-
-  double FP = Util::sumTotalLength(subtraction);
-
-
-  std::vector<Location *> * intersection = Util::locationIntersect(chromSats, testChrom->getRegionList());
-
-  double TP = Util::sumTotalLength(intersection);
+  double TP = truePositive;
+  double FP = falsePositive;
 
   double prec = 0;
 
@@ -165,11 +181,6 @@ double Client_Trainer::getPrecision(){
   } else {
     prec = TP / (TP + FP);
   }
-
-  Util::deleteInVector(intersection);
-  Util::deleteInVector(subtraction);
-  delete intersection;
-  delete subtraction;
   return prec;
 }
 
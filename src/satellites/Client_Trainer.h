@@ -29,7 +29,7 @@ namespace satellites {
 			vector<double>&);
 		virtual ~Client_Trainer();
 
-		vector<ILocation*>* getChromSats();
+		vector<Region>* getChromSats();
 
 		double getPrecision();
 		double getSensitivity();
@@ -42,9 +42,15 @@ namespace satellites {
 		ChromosomeTR * testChrom;
 		ScorerSat * train_scorer;
 		ScorerSat * test_scorer;
-		vector<ILocation*>* chromSats;
+		vector<Region>* chromSats;
+		// Bases of the test chromosome found correctly, found wrongly and
+		// missed, counted once after decoding
+		int truePositive;
+		int falsePositive;
+		int falseNegative;
 
 		void train();
+		bool collectPairs(Predictor<int> *, std::vector<std::string>&, int);
 	};
 }
 #endif
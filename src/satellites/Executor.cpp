@@ -117,32 +117,33 @@ namespace satellites
 
 			if(bed_motif_file == ""){
 				trainingChrom = new ChromosomeSelfTR(order, chrs->at(0),
-					'N', seg_size, minM, maxM, min_reg, 0);
+					'N', seg_size, minM, maxM, min_reg, 0, save_file);
 				testingChrom = new ChromosomeSelfTR(order, chrs->at(0),
-					'N', seg_size, minM, maxM, min_reg, 524287);
+					'N', seg_size, minM, maxM, min_reg, 524287, save_file);
 			}
 			else {
 				int segmentEnd = -1;
 				{
 					int segmentSize = 0;
-					for (int i = 0; i < chrs->at(0)->getSegment()->size() && segmentSize <= seg_size; i++)
+					const SegmentList * segmentList = chrs->at(0)->getSegment();
+					for (int i = 0; i < segmentList->size() && segmentSize <= seg_size; i++)
 					{
-						segmentEnd = chrs->at(0)->getSegment()->at(i)->at(1);
-						segmentSize += chrs->at(0)->getSegment()->at(i)->at(1) - chrs->at(0)->getSegment()->at(i)->at(0) + 1;
+						segmentEnd = segmentList->getEnd(i);
+						segmentSize += segmentList->getLength(i);
 					}
 				}
 				if(fa_motif_file == ""){
 
 					trainingChrom = new ChromosomeReadTR(order, chrs->at(0),
-						'N', segmentEnd + 1, trainFile, bed_motif_file, 0);
+						'N', segmentEnd + 1, trainFile, bed_motif_file, 0, save_file);
 					testingChrom = new ChromosomeReadTR(order, chrs->at(0),
-						'N', segmentEnd + 1, trainFile, bed_motif_file, 524287);
+						'N', segmentEnd + 1, trainFile, bed_motif_file, 524287, save_file);
 				} else {
 					ChromosomeOneDigit * read_from_chrom = new ChromosomeOneDigit(fa_motif_file);
 					trainingChrom = new ChromosomeReadTR(order, chrs->at(0),
-						'N', segmentEnd + 1, trainFile, bed_motif_file, read_from_chrom, 0);
+						'N', segmentEnd + 1, trainFile, bed_motif_file, read_from_chrom, 0, save_file);
 					testingChrom = new ChromosomeReadTR(order, chrs->at(0),
-						'N', segmentEnd + 1, trainFile, bed_motif_file, read_from_chrom, 524287);
+						'N', segmentEnd + 1, trainFile, bed_motif_file, read_from_chrom, 524287, save_file);
 				}
 			}
 
@@ -295,8 +296,12 @@ namespace satellites
 			}
 
 			const char *file_name = addr.c_str();
-			string str = outfile + "/" + string(basename((char *)file_name));
-			str = str.substr(0, str.size() - 2) + "bed";
+			string str = string(basename((char *)file_name));
+			if (str.size() > 3 && str.compare(str.size() - 3, 3, ".gz") == 0)
+			{
+				str.erase(str.size() - 3);
+			}
+			str = outfile + "/" + str.substr(0, str.find_last_of(".") + 1) + "bed";
 
 			ChromListMaker chromListMaker(addr, scanChromSize);
 			const vector<nonltr::ChromosomeOneDigit *> *chromList =
@@ -312,7 +317,7 @@ namespace satellites
 				min_reg, will_merge);
 
 		// Get results
-			vector<tuple<ILocation *, ChromosomeOneDigit *, string, string, double>> good_sats(
+			vector<tuple<Region, ChromosomeOneDigit *, string, string, double>> good_sats(
 				0);
 			cs->get_hmm_sats(good_sats);
 
@@ -327,9 +332,9 @@ namespace satellites
 				ChromosomeOneDigit *oneDigit = std::get<1>(good_sats[i]);
 				int newStart =
 				(chromListMaker.getStartOfChromosome(oneDigit)).second;
-				ILocation *oldLocation = std::get<0>(good_sats[i]);
-				oldLocation->setEnd(oldLocation->getEnd() + newStart);
-				oldLocation->setStart(oldLocation->getStart() + newStart);
+				Region &oldLocation = std::get<0>(good_sats[i]);
+				oldLocation.end += newStart;
+				oldLocation.start += newStart;
 			}
 
 			write_out(good_sats, str);
@@ -343,7 +348,7 @@ namespace satellites
 	}
 
 	void Executor::write_out(
-		vector<tuple<ILocation *, ChromosomeOneDigit *, string, string, double>> &regs,
+		vector<tuple<Region, ChromosomeOneDigit *, string, string, double>> &regs,
 		string &addr)
 	{
 #pragma omp critical
@@ -363,15 +368,15 @@ namespace satellites
 		for (auto &reg : regs)
 		{
 		// This length filter MAY CAUSE PROBLEMS for the mini or the full
-			if (std::get<0>(reg)->getLength() > (min_reg / 2) && (!mtf || std::get<4>(reg) >= idn))
+			if (std::get<0>(reg).getLength() > (min_reg / 2) && (!mtf || std::get<4>(reg) >= idn))
 			{
 				string header = std::get<1>(reg)->getHeader();
 				header = header.substr(1);
 				replace(header.begin(), header.end(), ' ', '_');
 
 				output_p << header << "\t";
-				output_p << std::get<0>(reg)->getStart() << "\t";
-				output_p << std::get<0>(reg)->getEnd() + 1 << "\t";
+				output_p << std::get<0>(reg).start << "\t";
+				output_p << std::get<0>(reg).end + 1 << "\t";
 				output_p << std::get<2>(reg) << "\t";
 				output_p << std::get<3>(reg) << "\t";
 				output_p << std::get<4>(reg) << endl;
@@ -80,7 +80,7 @@ namespace satellites {
 
 		void write_out(
 			vector<
-			tuple<ILocation*, ChromosomeOneDigit *, string, string,
+			tuple<Region, ChromosomeOneDigit *, string, string,
 			double> >&, string&);
 
 		void fillCompList();
@@ -52,13 +52,12 @@ namespace satellites {
  * Parameter chromSats: is a list of the found satellites
  */
 	void IClient::decode(ChromosomeOneDigit * chrom, ScorerSat * scorer,
-		vector<ILocation*>* chromSats) {
+		vector<Region>* chromSats) {
 
 		auto segmentList = chrom->getSegment();
 		for (int i = 0; i < segmentList->size(); i++) {
-			auto segment = segmentList->at(i);
-			int segStart = segment->at(0);
-			int segEnd = segment->at(1);
+			int segStart = segmentList->getStart(i);
+			int segEnd = segmentList->getEnd(i);
 			hmm->decode(segStart, segEnd, scorer->getFlatScores(), *chromSats);
 		}
 	}
@@ -21,7 +21,7 @@ public:
 	IClient(HMM *, vector<double>&, int, int, int, double);
 	virtual ~IClient();
 	HMM * getHMM();
-	void decode(ChromosomeOneDigit *, ScorerSat *,vector<ILocation*>*);
+	void decode(ChromosomeOneDigit *, ScorerSat *,vector<Region>*);
 
 protected:
 	// Used by the scorers
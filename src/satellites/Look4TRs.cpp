@@ -172,12 +172,13 @@ void printHelp()
 	<< endl << endl;
 	
 	cout
-	<< "--mtf <0|1>                                                                 "
+	<< "--mtf <0|1|2>                                                               "
 	<< endl;
 	cout << "    Enable ('1') or disable ('0') the motif discovery feature."
 	<< endl;
 	cout << "    If disabled ('0'), the locations of the repeats will be outputted, but Look4TRs will not attempt to discover " << endl;
 	cout << "    the motif that comprises the repeat." << endl;
+	cout << "    With '2', candidate motifs are confirmed by exact wraparound alignment instead of the trained predictor." << endl;
 	cout << "--prn <integer>" << endl;
 	cout
 	<< "   The size of the training set of the motif analyzer. Must be positive."
@@ -194,6 +195,10 @@ void printHelp()
 	<< endl;
 	cout << "   A directory where the --hmm, --glm, and --chmp files will be stored."
 	<< endl;
+	cout << "   The synthetic training and testing chromosomes are cached there too,"
+	<< endl;
+	cout << "   and are reloaded by later runs with the same training data and parameters."
+	<< endl;
 	cout << "--hmm <file>" << endl;
 	cout << "   The hmm file that is produced from a previous run that used --save-data." << endl;
 	cout << "   This HMM will be loaded, instead of training one."
@@ -711,9 +716,9 @@ int main(int argc, char *argv[])
 		<< endl;
 		exit(1);
 	}
-	else if (mtf != 0 && mtf != 1)
+	else if (mtf != 0 && mtf != 1 && mtf != 2)
 	{
-		cerr << "Want motif finding should be 0 or 1: " << mtf << endl;
+		cerr << "Want motif finding should be 0, 1 or 2: " << mtf << endl;
 		exit(1);
 	}
 
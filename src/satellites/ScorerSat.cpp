@@ -26,11 +26,11 @@ ScorerSat::ScorerSat(ChromosomeOneDigit& chromIn, int minKIn, int maxKIn,
 
 	scorerList = scorerListIn;
 
-	const vector<vector<int> *> * segmentList = chrom.getSegment();
+	const SegmentList * segmentList = chrom.getSegment();
 
 	for (int i = 0; i < segmentList->size(); i++) {
-		int start = segmentList->at(i)->at(0);
-		int end = segmentList->at(i)->at(1);
+		int start = segmentList->getStart(i);
+		int end = segmentList->getEnd(i);
 		if (halfW <= end - maxK + 1 - start) {
 			processSegment(start, end);
 		} else {
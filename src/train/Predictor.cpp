@@ -12,6 +12,7 @@
 #include "../cluster/DivergencePoint.h"
 #include "string.h"
 #include <random>
+#include <limits>
 
 
 
@@ -19,28 +20,55 @@ std::default_random_engine generatorPredictor (0);  // minstd_rand0 is a standar
 
 
 using namespace nonltr;
-template<class V>
-void fill_table(KmerHashTable<unsigned long, V> &table,
-	ChromosomeOneDigit *chrom, std::vector<V>& values) {
 
-	const int k = table.getK();
-	auto segment = chrom->getSegment();
+/*
+ * Counts the k-mers and the 1-mers of every segment in one sweep.
+ * The k-mer buffer uses the KmerHashTable layout (the index is the base-4
+ * representation of the k-mer, most significant nucleotide first, and every
+ * entry starts at 1). Both buffers are thread-local and reused between calls,
+ * so no table, hasher or key strings are built per sequence.
+ */
+template<class T>
+void fill_profile(int k, ChromosomeOneDigit *chrom,
+	const std::vector<T>* &counts_out, const std::vector<uint64_t>* &ones_out) {
 
-	const char *seg_bases = chrom->getBase()->c_str();
+	static thread_local std::vector<T> counts;
+	static thread_local std::vector<uint64_t> ones(4);
 
-	for (vector<int> *v : *segment) {
-		int start = v->at(0);
-		int end = v->at(1);
-		table.wholesaleIncrement(seg_bases, start, end - k + 1);
+	uint64_t table_size = 1;
+	for (int i = 0; i < k; i++) {
+		table_size *= 4;
 	}
+	const uint64_t mask = table_size - 1;
+	counts.assign(table_size, 1);
+	std::fill(ones.begin(), ones.end(), 0);
 
-	std::vector<std::string> *keys = table.getKeys();
-	for (std::string str : *keys) {
-		values.push_back(table.valueOf(str.c_str()));
+	const char *bases = chrom->getBase()->c_str();
+	const SegmentList * segmentList = chrom->getSegment();
+	for (int s = 0; s < segmentList->size(); s++) {
+		const int start = segmentList->getStart(s);
+		const int end = segmentList->getEnd(s);
+		uint64_t hash = 0;
+		for (int i = start; i <= end; i++) {
+			const char c = bases[i];
+			if (c < 0 || c > 3) {
+				string msg("The value of the char representing the nucleotide ");
+				msg.append("must be between 0 and 3.");
+				msg.append("The int value is ");
+				msg.append(Util::int2string((int) c));
+				msg.append(" of nucleotide at index ");
+				msg.append(Util::int2string(i));
+				throw InvalidInputException(msg);
+			}
+			ones[c]++;
+			hash = ((hash << 2) | c) & mask;
+			if (i - start + 1 >= k) {
+				counts[hash]++;
+			}
+		}
 	}
-	keys->clear();
-
-	delete keys;
+	counts_out = &counts;
+	ones_out = &ones;
 }
 
 template<class T>
@@ -49,17 +77,12 @@ Point<T>* Predictor<T>::get_point(nonltr::ChromosomeOneDigit *chrom) {
 		return NULL;
 	}
 
-	KmerHashTable<unsigned long, T> table(k, 1);
-	KmerHashTable<unsigned long, uint64_t> table_k1(1, 0);
-	std::vector<T> values;
-	vector<uint64_t> values_k1;
-
-	values.clear();
-	fill_table<T>(table, chrom, values);
-	fill_table<uint64_t>(table_k1, chrom, values_k1);
-	Point<T> *p = new DivergencePoint<T>(values, chrom->size());
+	const std::vector<T> *values;
+	const std::vector<uint64_t> *values_k1;
+	fill_profile<T>(k, chrom, values, values_k1);
+	Point<T> *p = new DivergencePoint<T>(*values, chrom->size());
 
-	p->set_1mers(values_k1);
+	p->set_1mers(*values_k1);
 	p->set_header(chrom->getHeader());
 	p->set_length(chrom->getBase()->length());
 	p->set_data_str(*chrom->getBase());
@@ -74,7 +97,10 @@ Point<T>* Predictor<T>::get_point(nonltr::ChromosomeOneDigit *chrom) {
 	}
 	sq = sqrt(sq / N);
 	q->set_stddev(sq);
-	p->set_id(seq_num++);
+	uint64_t p_id;
+#pragma omp atomic capture
+	p_id = seq_num++;
+	p->set_id(p_id);
 	return p;
 }
 
@@ -108,15 +134,20 @@ Predictor<T>::Predictor(const std::string filename) {
 	in >> buf >> id;
 	cout << buf << id << endl;
 	is_trained = true;
+	is_training = false;
+	is_collecting = false;
+	seq_num = 0;
 	if (mode & PRED_MODE_CLASS) {
 		auto pr = read_from(in, k);
 		c_glm = pr.first;
 		feat_c = pr.second;
+		compile(feat_c, c_glm, c_flat);
 	}
 	if (mode & PRED_MODE_REGR) {
 		auto pr = read_from(in, k);
 		r_glm = pr.first;
 		feat_r = pr.second;
+		compile(feat_r, r_glm, r_flat);
 	}
 	omp_init_lock(&lock);
 }
@@ -248,61 +279,163 @@ void Predictor<T>::add_feats(std::vector<std::pair<uint64_t, Combo> >& vec,
 	}
 }
 
+/*
+ * Stores an aligned pair for training. The points are cloned only when the
+ * pair is actually kept; clones carry the k-mer profile but not the sequence.
+ */
 template<class T>
-double Predictor<T>::similarity(Point<T>* a, Point<T>* b) {
+void Predictor<T>::add_pair(Point<T>* a, Point<T>* b, double val) {
+	if (is_collecting) {
+		auto sink = sinks.at(omp_get_thread_num());
+		if (sink != NULL) {
+			pra<T> pr;
+			pr.first = a->clone();
+			pr.second = b->clone();
+			pr.val = val;
+			sink->push_back(pr);
+		}
+		return;
+	}
+	if (is_training) {
+		return;
+	}
+	omp_set_lock(&lock);
 	if (!is_trained) {
-		double d = Selector<T>::align(a, b);
 		pra<T> pr;
-		pr.first = a->clone();
-		pr.second = b->clone();
-		pr.val = d;
-		if (!is_training) {
-			omp_set_lock(&lock);
-			if (training.size() < testing.size()
-				&& training.size() < threshold) {
-				training.push_back(pr);
-		}
-		else if (training.size() >= testing.size() && testing.size() < threshold) {
+		pr.val = val;
+		if (training.size() < testing.size()
+			&& training.size() < threshold) {
+			pr.first = a->clone();
+			pr.second = b->clone();
+			training.push_back(pr);
+		} else if (training.size() >= testing.size()
+			&& testing.size() < threshold) {
+			pr.first = a->clone();
+			pr.second = b->clone();
 			testing.push_back(pr);
-		} 
-		else {
+		} else {
 			is_training = true;
 			train();
 			is_training = false;
 		}
-		omp_unset_lock(&lock);
 	}
-	return d;
-} 
-else {
-	return predict(a, b);
+	omp_unset_lock(&lock);
 }
+
+template<class T>
+void Predictor<T>::begin_collect(int num_threads) {
+	sinks.assign(std::max(num_threads, 1), NULL);
+	is_collecting = true;
 }
 
 template<class T>
-bool Predictor<T>::close(Point<T> *a, Point<T> *b) {
-	if (!is_trained) {
-		double d = Selector<T>::align(a, b);
-		pra<T> pr;
-		pr.first = a->clone();
-		pr.second = b->clone();
-		pr.val = d;
-		if (!is_training) {
-			omp_set_lock(&lock);
-			if (training.size() < testing.size()
-				&& training.size() < threshold) {
-				training.push_back(pr);
+void Predictor<T>::collect_into(vector<pra<T> > *sink) {
+	sinks.at(omp_get_thread_num()) = sink;
+}
+
+/*
+ * Adds pairs the same way add_pair does, alternating between the testing
+ * and the training sets. Pairs that do not fit are freed. Returns true
+ * once both sets are full.
+ */
+template<class T>
+bool Predictor<T>::add_collected(vector<pra<T> > &pairs) {
+	for (auto pr : pairs) {
+		if (training.size() < testing.size()
+			&& training.size() < threshold) {
+			training.push_back(pr);
 		} else if (training.size() >= testing.size()
 			&& testing.size() < threshold) {
 			testing.push_back(pr);
 		} else {
-			is_training = true;
-			train();
-			is_training = false;
+			delete pr.first;
+			delete pr.second;
 		}
-		omp_unset_lock(&lock);
 	}
-	return d;
+	pairs.clear();
+	return training.size() >= threshold && testing.size() >= threshold;
+}
+
+template<class T>
+void Predictor<T>::end_collect() {
+	is_collecting = false;
+	sinks.clear();
+	if (!is_trained && training.size() >= threshold
+		&& testing.size() >= threshold) {
+		is_training = true;
+		train();
+		is_training = false;
+	}
+}
+
+template<class T>
+double Predictor<T>::similarity(Point<T>* a, Point<T>* b) {
+	if (!is_trained) {
+		double d = Selector<T>::align(a, b);
+		add_pair(a, b, d);
+		return d;
+	} else {
+		return predict(a, b);
+	}
+}
+
+template<class T>
+std::pair<int, double> Predictor<T>::best_similarity(Point<T>* query,
+	const std::vector<Point<T>*>& cands, const std::vector<size_t>& tie_keys) {
+	if (cands.size() != tie_keys.size()) {
+		string msg("Each candidate needs exactly one tie key.");
+		throw InvalidInputException(msg);
+	}
+
+	typename Feature<T>::fused_side side;
+	bool prepared = false;
+
+	int best = -1;
+	double best_sim = -1;
+	for (size_t i = 0; i < cands.size(); i++) {
+		double sim;
+		if (!is_trained) {
+			// Still collecting aligned pairs, which may finish training
+			sim = similarity(query, cands[i]);
+		} else {
+			if (!prepared) {
+				side = Feature<T>::fused_prepare(*query);
+				prepared = true;
+			}
+			if ((mode & PRED_MODE_CLASS)
+				&& !(flat_eval(c_flat, feat_c, query, cands[i], &side) > 0.0)) {
+				sim = 0;
+			} else {
+				sim = flat_eval(r_flat, feat_r, query, cands[i], &side);
+				if (sim < 0) {
+					sim = 0;
+				} else if (sim > 1) {
+					sim = 1;
+				}
+				if (sim != sim) {
+					sim = Selector<T>::align(query, cands[i]);
+				}
+			}
+		}
+
+		if (best >= 0 && fabs(best_sim - sim) < std::numeric_limits<double>::epsilon()
+			&& tie_keys[i] < tie_keys[best]) {
+			best = i;
+			best_sim = sim;
+		} else if (sim > best_sim) {
+			best = i;
+			best_sim = sim;
+		}
+	}
+	return std::make_pair(best, best_sim);
+}
+
+template<class T>
+bool Predictor<T>::close(Point<T> *a, Point<T> *b) {
+	if (!is_trained) {
+		double d = Selector<T>::align(a, b);
+		add_pair(a, b, d);
+		return d;
 } else {
 	bool val = p_close(a, b);
 	if ((mode & PRED_MODE_REGR) && val) {
@@ -313,14 +446,97 @@ bool Predictor<T>::close(Point<T> *a, Point<T> *b) {
 }
 
 template<class T>
-double Predictor<T>::p_predict(Point<T>* a, Point<T>* b) {
-	auto cache = feat_r->compute(*a, *b);
-	auto weights = r_glm.get_weights();
-	double sum = weights.get(0, 0);
-	for (int col = 0; col < feat_r->size(); col++) {
-		double val = (*feat_r)(col, cache);
-		sum += weights.get(col + 1, 0) * val;
+void Predictor<T>::compile(const Feature<T>* feat, const matrix::GLM& glm,
+	flat_model& model) {
+	auto combos = feat->get_combos();
+	auto mins = feat->get_mins();
+	auto maxs = feat->get_maxs();
+	const matrix::Matrix& weights = glm.get_weights();
+	if (feat->raw_size() > 64) {
+		string msg("Too many raw features to compile the model: ");
+		msg.append(Util::int2string(feat->raw_size()));
+		throw InvalidInputException(msg);
+	}
+
+	model.bias = weights.get(0, 0);
+	model.mins = mins;
+	model.maxs = maxs;
+	model.is_sims.clear();
+	for (auto f : feat->get_lookup()) {
+		model.is_sims.push_back(feat->feat_is_sim(f));
+	}
+	model.terms.clear();
+	for (size_t col = 0; col < combos.size(); col++) {
+		const auto& indices = combos[col].second;
+		const Combo combo = combos[col].first;
+		if (indices.empty() || indices.size() > 2
+			|| (indices.size() == 1 && combo != Combo::xy && combo != Combo::x2y2)) {
+			string msg("Cannot compile a combo of ");
+			msg.append(Util::int2string(indices.size()));
+			msg.append(" features");
+			throw InvalidInputException(msg);
+		}
+		flat_term term;
+		term.i0 = indices[0];
+		term.i1 = indices.size() == 2 ? indices[1] : -1;
+		term.combo = combo;
+		term.weight = weights.get(col + 1, 0);
+		model.terms.push_back(term);
+	}
+}
+
+/*
+ * Mirrors Feature::compute followed by Feature::operator() for every
+ * column, using the same arithmetic so the sums are identical.
+ */
+template<class T>
+double Predictor<T>::flat_eval(const flat_model& model, Feature<T>* feat,
+	Point<T>* a, Point<T>* b,
+	const typename Feature<T>::fused_side *aside) const {
+	double cache[64];
+	feat->compute_all_raw(*a, *b, cache, aside);
+	const size_t n_raw = model.mins.size();
+	for (size_t i = 0; i < n_raw; i++) {
+		double val = (cache[i] - model.mins[i]) / (model.maxs[i] - model.mins[i]);
+		if (val < 0) {
+			val = 0;
+		} else if (val > 1) {
+			val = 1;
+		}
+		cache[i] = model.is_sims[i] ? val : 1 - val;
+	}
+
+	double sum = model.bias;
+	for (const flat_term& t : model.terms) {
+		const double x = cache[t.i0];
+		double val;
+		if (t.i1 < 0) {
+			val = (t.combo == Combo::x2y2) ? x * x : x;
+		} else {
+			const double y = cache[t.i1];
+			switch (t.combo) {
+			case Combo::xy:
+				val = x * y;
+				break;
+			case Combo::x2y2:
+				val = (x * x) * (y * y);
+				break;
+			case Combo::xy2:
+				val = x * y * y;
+				break;
+			default:
+				val = x * x * y;
+				break;
+			}
+		}
+		sum += t.weight * val;
 	}
+	return sum;
+}
+
+template<class T>
+double Predictor<T>::p_predict(Point<T>* a, Point<T>* b) {
+	double sum = flat_eval(r_flat, feat_r, a, b);
 	if (sum < 0) {
 		sum = 0;
 	} else if (sum > 1) {
@@ -344,14 +560,7 @@ double Predictor<T>::predict(Point<T>* a, Point<T>* b) {
 
 template<class T>
 bool Predictor<T>::p_close(Point<T>* a, Point<T>* b) {
-	auto weights = c_glm.get_weights();
-	double sum = weights.get(0, 0);
-	auto cache = feat_c->compute(*a, *b);
-	for (int col = 1; col < weights.getNumRow(); col++) {
-		double d = (*feat_c)(col - 1, cache);
-		sum += weights.get(col, 0) * d;
-	}
-	return sum > 0.0;
+	return flat_eval(c_flat, feat_c, a, b) > 0.0;
 }
 
 template<class T>
@@ -462,6 +671,195 @@ tuple<double, double, double> class_test(const vector<pra<T> >& data,
 	return glm.accuracy(pr.second, p);
 }
 
+/*
+ * The normalized value of every raw feature of the candidate combos for
+ * every training and testing pair, one column per raw feature, indexed by
+ * log2 of its flag. The raw value of a pair never changes, and the bounds
+ * of a raw feature come from the training pairs only, so the columns are
+ * computed once and each candidate of a selection round only combines
+ * them. The arithmetic matches Feature::normalize, compute and operator(),
+ * so the design matrices are the ones generate_feat_mat would build.
+ */
+template<class T>
+struct feature_columns {
+	std::vector<double> mins, maxs;
+	std::vector<std::vector<double> > train, test;
+};
+
+template<class T>
+void fill_raw_columns(Feature<T>& all, const vector<pra<T> >& pairs,
+	std::vector<std::vector<double> >& cols) {
+	auto lookup = all.get_lookup();
+	for (auto flag : lookup) {
+		cols[Feature<T>::log2(flag)].resize(pairs.size());
+	}
+	// Alignment fills a shared table, everything else only reads the pair
+	bool is_pure = std::find(lookup.begin(), lookup.end(), FEAT_ALIGN)
+		== lookup.end();
+	#pragma omp parallel for schedule(dynamic, 64) num_threads(std::max(1, (int) Util::CORE_NUM)) if(is_pure)
+	for (size_t row = 0; row < pairs.size(); row++) {
+		double raw[64];
+		all.compute_all_raw(*pairs[row].first, *pairs[row].second, raw);
+		for (size_t i = 0; i < lookup.size(); i++) {
+			cols[Feature<T>::log2(lookup[i])][row] = raw[i];
+		}
+	}
+}
+
+template<class T>
+void normalize_column(std::vector<double>& col, double min, double max,
+	bool is_sim) {
+	for (size_t row = 0; row < col.size(); row++) {
+		double val = (col[row] - min) / (max - min);
+		if (val < 0) {
+			val = 0;
+		} else if (val > 1) {
+			val = 1;
+		}
+		col[row] = is_sim ? val : 1 - val;
+	}
+}
+
+template<class T>
+void make_feature_columns(int k,
+	const vector<std::pair<uint64_t, Combo> >& possible,
+	const vector<pra<T> >& training, const vector<pra<T> >& testing,
+	feature_columns<T>& cols) {
+	uint64_t flags = 0;
+	for (auto& pr : possible) {
+		flags |= pr.first;
+	}
+	Feature<T> all(k);
+	all.set_save(false);
+	all.add_feature(flags, Combo::xy);
+
+	cols.mins.assign(64, 0);
+	cols.maxs.assign(64, 0);
+	cols.train.assign(64, std::vector<double>());
+	cols.test.assign(64, std::vector<double>());
+	fill_raw_columns(all, training, cols.train);
+	fill_raw_columns(all, testing, cols.test);
+
+	for (auto flag : all.get_lookup()) {
+		int idx = Feature<T>::log2(flag);
+		double small = std::numeric_limits<double>::max();
+		double big = std::numeric_limits<double>::min();
+		if (flag == FEAT_ALIGN) {
+			small = 0;
+			big = 1;
+		} else {
+			for (double val : cols.train[idx]) {
+				if (val < small) {
+					small = val;
+				}
+				if (val > big) {
+					big = val;
+				}
+			}
+		}
+		cols.mins[idx] = small;
+		cols.maxs[idx] = big;
+		bool is_sim = all.feat_is_sim(flag);
+		normalize_column<T>(cols.train[idx], small, big, is_sim);
+		normalize_column<T>(cols.test[idx], small, big, is_sim);
+	}
+}
+
+/*
+ * The design matrix of the combos: a column of ones, then one column per
+ * combo, whose raw features are taken in flag order as add_feature does.
+ */
+template<class T>
+matrix::Matrix combo_matrix(const std::vector<std::vector<double> >& cols,
+	size_t nrows, const vector<std::pair<uint64_t, Combo> >& combos) {
+	matrix::Matrix feat_mat(nrows, combos.size() + 1);
+	for (size_t row = 0; row < nrows; row++) {
+		feat_mat.set(row, 0, 1);
+	}
+	for (size_t col = 0; col < combos.size(); col++) {
+		vector<const double*> ins;
+		for (uint64_t f = 1; f <= combos[col].first; f <<= 1) {
+			if (combos[col].first & f) {
+				ins.push_back(cols[Feature<T>::log2(f)].data());
+			}
+		}
+		Combo combo = combos[col].second;
+		if ((combo == Combo::xy2 || combo == Combo::x2y) && ins.size() != 2) {
+			throw "invalid";
+		}
+		for (size_t row = 0; row < nrows; row++) {
+			double val = 1;
+			if (combo == Combo::xy) {
+				for (auto in : ins) {
+					val *= in[row];
+				}
+			} else if (combo == Combo::x2y2) {
+				for (auto in : ins) {
+					val *= in[row] * in[row];
+				}
+			} else if (combo == Combo::xy2) {
+				val = ins[0][row] * ins[1][row] * ins[1][row];
+			} else {
+				val = ins[0][row] * ins[0][row] * ins[1][row];
+			}
+			feat_mat.set(row, col + 1, val);
+		}
+	}
+	return feat_mat;
+}
+
+template<class T>
+matrix::Matrix label_matrix(const vector<pra<T> >& data, double cutoff) {
+	bool classify = (cutoff >= 0);
+	matrix::Matrix labels(data.size(), 1);
+	for (size_t row = 0; row < data.size(); row++) {
+		if (classify) {
+			labels.set(row, 0, data[row].val >= cutoff ? 1 : -1);
+		} else {
+			labels.set(row, 0, data[row].val);
+		}
+	}
+	return labels;
+}
+
+double mean_abs_error(const matrix::Matrix& feat_mat,
+	const matrix::Matrix& labels, const matrix::GLM& glm) {
+	auto diff = feat_mat * glm.get_weights() - labels;
+	double sum = 0;
+	for (int i = 0; i < diff.getNumRow(); i++) {
+		sum += fabs(diff.get(i, 0));
+	}
+	return sum / diff.getNumRow();
+}
+
+tuple<double, double, double> class_stats(matrix::Matrix& feat_mat,
+	matrix::Matrix& labels, const matrix::GLM& glm) {
+	matrix::Matrix p = glm.predict(feat_mat);
+	for (int row = 0; row < p.getNumRow(); row++) {
+		if (p.get(row, 0) == 0) {
+			p.set(row, 0, -1);
+		}
+	}
+	return glm.accuracy(labels, p);
+}
+
+/*
+ * Adds a selected combo to feat with the bounds already found for its
+ * raw features
+ */
+template<class T>
+void add_selected(Feature<T>* feat, const std::pair<uint64_t, Combo>& rfeat,
+	const feature_columns<T>& cols) {
+	feat->add_feature(rfeat.first, rfeat.second);
+	for (uint64_t f = 1; f <= rfeat.first; f <<= 1) {
+		if (rfeat.first & f) {
+			int idx = Feature<T>::log2(f);
+			feat->set_normal(f, cols.mins[idx], cols.maxs[idx]);
+		}
+	}
+	feat->finalize();
+}
+
 template<class T>
 void Predictor<T>::filter() {
 	training.clear();
@@ -500,6 +898,12 @@ void balance(std::vector<pra<T> > &vec, double id) {
 		vec.push_back(positive[i]);
 		vec.push_back(negative[i]);
 	}
+	for (auto& rest : {&positive, &negative}) {
+		for (uint64_t i = tr_size; i < rest->size(); i++) {
+			delete (*rest)[i].first;
+			delete (*rest)[i].second;
+		}
+	}
 	// cout << "Positive: " << tr_size << " Negative: " << tr_size << endl;
 }
 template<class T>
@@ -557,6 +961,14 @@ void Predictor<T>::train() {
 		train_regr(&feat);
 	}
 	feat.set_save(false);
+	for (auto p : training) {
+		delete p.first;
+		delete p.second;
+	}
+	for (auto p : testing) {
+		delete p.first;
+		delete p.second;
+	}
 	training.clear();
 	testing.clear();
 	possible_feats.clear();
@@ -569,7 +981,13 @@ void Predictor<T>::train_class(Feature<T>* feat) {
 	for (int i = 0; i < c_size; i++) {
 		feat->remove_feature();
 	}
+	feature_columns<T> cols;
+	make_feature_columns(k, possible_feats, training, testing, cols);
+	matrix::Matrix tr_labels = label_matrix(training, id);
+	matrix::Matrix te_labels = label_matrix(testing, id);
+
 	vector<uintmax_t> used_list;
+	vector<std::pair<uint64_t, Combo> > chosen;
 	std::tuple<double, double, double> abs_best_acc, abs_best_tr_acc;
 	get<0>(abs_best_acc) = 0;
 	for (auto num_feat = 1; num_feat <= max_num_feat; num_feat++) {
@@ -577,39 +995,55 @@ void Predictor<T>::train_class(Feature<T>* feat) {
 		std::tuple<double, double, double> best_class_tr_acc;
 		uintmax_t best_idx = -1, cur_idx = 1;
 		auto best_class_feat = possible_feats.front();
+
+		// Each candidate extends the model of the combos chosen so far by
+		// one column. The candidates are fit in parallel and compared in
+		// order.
+		auto base_mat = combo_matrix<T>(cols.train, training.size(), chosen);
+		matrix::GLM base;
+		base.train(base_mat, tr_labels);
+		vector<std::tuple<double, double, double> > tr_accs(possible_feats.size());
+		vector<std::tuple<double, double, double> > te_accs(possible_feats.size());
+		#pragma omp parallel for schedule(dynamic) num_threads(std::max(1, (int) Util::CORE_NUM))
 		for (uint64_t i = 0; i < possible_feats.size(); i++) {
 			if (std::find(used_list.begin(), used_list.end(), i)
 				!= used_list.end()) {
 				continue;
+			}
+			auto combos = chosen;
+			combos.push_back(possible_feats[i]);
+			auto tr_mat = combo_matrix<T>(cols.train, training.size(), combos);
+			matrix::GLM glm;
+			glm.train(base, tr_mat, tr_labels);
+			tr_accs[i] = class_stats(tr_mat, tr_labels, glm);
+			auto te_mat = combo_matrix<T>(cols.test, testing.size(), combos);
+			te_accs[i] = class_stats(te_mat, te_labels, glm);
 		}
-		auto rfeat = possible_feats[i];
-		feat->add_feature(rfeat.first, rfeat.second);
-		feat->normalize(training);
-		feat->finalize();
-		auto pr = class_train(training, *feat, id);
-		auto class_ac = class_test(testing, *feat, pr.second, id);
-		feat->remove_feature();
-
-		if (get<0>(class_ac) > get<0>(best_class_acc)) {
-			best_class_acc = class_ac;
-			best_class_feat = rfeat;
-			best_class_tr_acc = pr.first;
-			best_idx = i;
+		for (uint64_t i = 0; i < possible_feats.size(); i++) {
+			if (std::find(used_list.begin(), used_list.end(), i)
+				!= used_list.end()) {
+				continue;
+			}
+			if (get<0>(te_accs[i]) > get<0>(best_class_acc)) {
+				best_class_acc = te_accs[i];
+				best_class_feat = possible_feats[i];
+				best_class_tr_acc = tr_accs[i];
+				best_idx = i;
+			}
+		}
+		if (get<0>(best_class_acc) > get<0>(abs_best_acc)) {
+			add_selected(feat, best_class_feat, cols);
+			chosen.push_back(best_class_feat);
+			abs_best_acc = best_class_acc;
+			abs_best_tr_acc = best_class_tr_acc;
+			used_list.push_back(best_idx);
 		}
 	}
-	if (get<0>(best_class_acc) > get<0>(abs_best_acc)) {
-		feat->add_feature(best_class_feat.first, best_class_feat.second);
-		feat->normalize(training);
-		feat->finalize();
-		abs_best_acc = best_class_acc;
-		abs_best_tr_acc = best_class_tr_acc;
-		used_list.push_back(best_idx);
-	}
-}
 feat_c = new Feature<T>(*feat);
 feat_c->set_save(false);
 auto pr = class_train(training, *feat_c, id);
 c_glm = pr.second;
+compile(feat_c, c_glm, c_flat);
 cout << "Classification Training ACC: " << get<0>(pr.first) << " SENS: "
 << get<1>(pr.first) << " SPEC: " << get<2>(pr.first) << endl;
 auto stats = class_test(testing, *feat_c, c_glm, id);
@@ -622,45 +1056,64 @@ void Predictor<T>::train_regr(Feature<T>* feat) {
 	for (int i = 0; i < c_size; i++) {
 		feat->remove_feature();
 	}
+	feature_columns<T> cols;
+	make_feature_columns(k, possible_feats, training, testing, cols);
+	matrix::Matrix tr_labels = label_matrix(training, -1);
+	matrix::Matrix te_labels = label_matrix(testing, -1);
+
 	vector<uintmax_t> used_list;
+	vector<std::pair<uint64_t, Combo> > chosen;
 	double abs_best_regr = 1000000;
 
 	for (auto num_feat = 1; num_feat <= max_num_feat; num_feat++) {
 		double best_regr_err = abs_best_regr;
 		uintmax_t best_idx = -1, cur_idx = 1;
 		auto best_regr_feat = possible_feats.front();
+
+		// Each candidate extends the model of the combos chosen so far by
+		// one column. The candidates are fit in parallel and compared in
+		// order.
+		auto base_mat = combo_matrix<T>(cols.train, training.size(), chosen);
+		matrix::GLM base;
+		base.train(base_mat, tr_labels);
+		vector<double> errs(possible_feats.size());
+		#pragma omp parallel for schedule(dynamic) num_threads(std::max(1, (int) Util::CORE_NUM))
+		for (uint64_t i = 0; i < possible_feats.size(); i++) {
+			if (std::find(used_list.begin(), used_list.end(), i)
+				!= used_list.end()) {
+				continue;
+			}
+			auto combos = chosen;
+			combos.push_back(possible_feats[i]);
+			auto tr_mat = combo_matrix<T>(cols.train, training.size(), combos);
+			matrix::GLM glm;
+			glm.train(base, tr_mat, tr_labels);
+			auto te_mat = combo_matrix<T>(cols.test, testing.size(), combos);
+			errs[i] = mean_abs_error(te_mat, te_labels, glm);
+		}
 		for (uint64_t i = 0; i < possible_feats.size(); i++) {
 			if (std::find(used_list.begin(), used_list.end(), i)
 				!= used_list.end()) {
 				continue;
+			}
+			if (errs[i] < best_regr_err) {
+				best_regr_err = errs[i];
+				best_regr_feat = possible_feats[i];
+				best_idx = i;
+			}
 		}
-		auto rfeat = possible_feats[i];
-		feat->add_feature(rfeat.first, rfeat.second);
-		feat->normalize(training);
-		feat->finalize();
-		auto pr = regression_train(training, *feat);
-		double regr_mse = regression_test(testing, *feat, pr.second);
-		feat->remove_feature();
-
-		if (regr_mse < best_regr_err) {
-			best_regr_err = regr_mse;
-			best_regr_feat = rfeat;
-			best_idx = i;
+		if (best_regr_err < abs_best_regr) {
+			add_selected(feat, best_regr_feat, cols);
+			chosen.push_back(best_regr_feat);
+			abs_best_regr = best_regr_err;
+			used_list.push_back(best_idx);
 		}
 	}
-	if (best_regr_err < abs_best_regr) {
-		feat->add_feature(best_regr_feat.first, best_regr_feat.second);
-		feat->normalize(training);
-		feat->finalize();
-		abs_best_regr = best_regr_err;
-		used_list.push_back(best_idx);
-
-	}
-}
 feat_r = new Feature<T>(*feat);
 feat_r->set_save(false);
 auto pr = regression_train(training, *feat_r);
 r_glm = pr.second;
+compile(feat_r, r_glm, r_flat);
 
 double regr_mse = regression_test(testing, *feat_r, r_glm);
 }
@@ -26,7 +26,8 @@ template<class T>
  	Predictor(int k_, double id_, uint8_t mode_, uint64_t feats,
  		int threshold_ = 100, int max_num_feat_ = 4) :
  	threshold(threshold_), k(k_), id(id_), is_trained(false), is_training(
- 		false), mode(mode_), max_num_feat(max_num_feat_) {
+ 		false), is_collecting(false), mode(mode_), max_num_feat(max_num_feat_),
+ 		seq_num(0) {
  		if (id < 0 || id > 1) {
  			cerr << "Identity score must be between 0 and 1" << endl;
  			throw 0;
@@ -63,17 +64,41 @@ template<class T>
  	void train(const std::vector<Point<T>*>& vec, size_t sample_size,
  		size_t max_pts_from_one);
  	double similarity(Point<T>* a, Point<T>* b);
+ 	/*
+ 	 * Scores query against every candidate and returns the index of the
+ 	 * most similar candidate with its similarity. On equal similarity the
+ 	 * candidate with the smaller tie key (e.g. the shorter motif) wins.
+ 	 * Terms that depend only on the query are computed once.
+ 	 */
+ 	std::pair<int, double> best_similarity(Point<T>* query,
+ 		const std::vector<Point<T>*>& cands,
+ 		const std::vector<size_t>& tie_keys);
  	bool close(Point<T>* a, Point<T>* b);
  	void save(std::string file);
  	Point<T>* get_point(nonltr::ChromosomeOneDigit *chrom);
  	bool get_is_trained() const { return is_trained; }
 
+ 	/*
+ 	 * Collecting training pairs from many threads:
+ 	 *   begin_collect(number of threads);
+ 	 *   in each thread: collect_into(&pairs); ...similarity calls...; collect_into(NULL);
+ 	 *   add_collected(pairs) in a fixed order until it returns true
+ 	 *   end_collect();   // fits the model once
+ 	 * While collecting, untrained similarity calls only label pairs and
+ 	 * hand them to the calling thread's sink, without taking the lock.
+ 	 */
+ 	void begin_collect(int num_threads);
+ 	void collect_into(vector<pra<T> > *sink);
+ 	bool add_collected(vector<pra<T> > &pairs);
+ 	void end_collect();
+
  private:
 
  	static void add_feats(std::vector<std::pair<uint64_t, Combo> >& vec,
  		uint64_t flags);
  	static pair<matrix::GLM, Feature<T>*> read_from(std::ifstream &in, int k_);
  	static void write_to(std::ofstream &out, Feature<T>* f, matrix::GLM glm);
+ 	void add_pair(Point<T>* a, Point<T>* b, double val);
  	void filter();
  	void train();
  	void train_class(Feature<T>* feat);
@@ -83,11 +108,34 @@ template<class T>
  	bool p_close(Point<T>* a, Point<T>* b);
  	double p_predict(Point<T>* a, Point<T>* b);
 
+ 	/*
+ 	 * A trained model flattened for inference: the normalization bounds
+ 	 * of each raw feature followed by one term per combo, so that scoring
+ 	 * a pair is a single loop with no weight copies or Matrix lookups.
+ 	 */
+ 	struct flat_term {
+ 		int i0, i1; // i1 is -1 for a combo of a single feature
+ 		Combo combo;
+ 		double weight;
+ 	};
+ 	struct flat_model {
+ 		double bias;
+ 		std::vector<double> mins, maxs;
+ 		std::vector<char> is_sims;
+ 		std::vector<flat_term> terms;
+ 	};
+ 	static void compile(const Feature<T>* feat, const matrix::GLM& glm,
+ 		flat_model& model);
+ 	double flat_eval(const flat_model& model, Feature<T>* feat, Point<T>* a,
+ 		Point<T>* b, const typename Feature<T>::fused_side *aside = NULL) const;
+
  	Selector<T> *selector = NULL;
  	Feature<T> *feat_c, *feat_r;
  	matrix::GLM c_glm, r_glm;
+ 	flat_model c_flat, r_flat;
  	vector<pra<T> > training, testing;
- 	bool is_trained, is_training;
+ 	bool is_trained, is_training, is_collecting;
+ 	vector<vector<pra<T> > *> sinks;
  	int max_num_feat, k, threshold;
  	uint8_t mode;
  	double id;
@@ -0,0 +1,55 @@
+/*
+ * CounterRandom.h
+ *
+ * A counter-based random number generator: the n-th number of a stream is
+ * a hash of the stream key and n (the SplitMix64 mixer). Streams made from
+ * one seed and different stream numbers are independent, so work split
+ * across threads draws the same numbers however it is scheduled.
+ *
+ * It meets the requirements of a uniform random bit generator, so it can
+ * drive the distributions of <random>.
+ */
+
+#ifndef COUNTERRANDOM_H_
+#define COUNTERRANDOM_H_
+
+#include <stdint.h>
+
+namespace utility {
+
+	class CounterRandom {
+	private:
+		uint64_t key;
+		uint64_t counter;
+
+		static uint64_t mix(uint64_t z) {
+			z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+			z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+			return z ^ (z >> 31);
+		}
+
+	public:
+		typedef uint64_t result_type;
+
+		CounterRandom(uint64_t seed, uint64_t stream) {
+			key = mix(mix(seed + 0x9E3779B97F4A7C15ULL) ^ stream);
+			counter = 0;
+		}
+
+		static constexpr result_type min() {
+			return 0;
+		}
+
+		static constexpr result_type max() {
+			return ~(result_type) 0;
+		}
+
+		result_type operator()() {
+			counter++;
+			return mix(key + counter * 0x9E3779B97F4A7C15ULL);
+		}
+	};
+
+} /* namespace utility */
+
+#endif /* COUNTERRANDOM_H_ */
@@ -0,0 +1,337 @@
+/*
+ * FastaReader.cpp
+ */
+
+#include "FastaReader.h"
+#include "Util.h"
+#include "../exception/InvalidInputException.h"
+
+#include <algorithm>
+#include <errno.h>
+#include <fcntl.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <zlib.h>
+
+using namespace exception;
+
+namespace utility {
+
+	FastaReader::FastaReader(string fileNameIn) {
+		fileName = fileNameIn;
+		data = NULL;
+		dataSize = 0;
+
+		int fd = open(fileName.c_str(), O_RDONLY);
+		struct stat info;
+		if (fd < 0 || fstat(fd, &info) != 0) {
+			int code = errno;
+			if (fd >= 0) {
+				close(fd);
+			}
+			string msg("Cannot open ");
+			msg.append(fileName);
+			msg.append(". System code is: ");
+			msg.append(Util::int2string(code));
+			throw InvalidInputException(msg);
+		}
+
+		dataSize = info.st_size;
+		if (dataSize > 0) {
+			void * map = mmap(NULL, dataSize, PROT_READ, MAP_PRIVATE, fd, 0);
+			if (map == MAP_FAILED) {
+				int code = errno;
+				close(fd);
+				string msg("Cannot map ");
+				msg.append(fileName);
+				msg.append(". System code is: ");
+				msg.append(Util::int2string(code));
+				throw InvalidInputException(msg);
+			}
+			madvise(map, dataSize, MADV_SEQUENTIAL);
+			data = (const char *) map;
+		}
+		// The map stays valid after the descriptor is closed
+		close(fd);
+
+		if (isGzip(data, dataSize)) {
+			vector<size_t> blockStart;
+			vector<size_t> outputStart;
+			if (findBgzfBlocks(data, dataSize, blockStart, outputStart)) {
+				inflateBgzf(data, blockStart, outputStart);
+			} else {
+				inflateGzip(data, dataSize);
+			}
+			munmap((void *) data, dataSize);
+			data = inflated.empty() ? NULL : inflated.data();
+			dataSize = inflated.size();
+		}
+
+		findRecords();
+	}
+
+	FastaReader::~FastaReader() {
+		if (data != NULL && inflated.empty()) {
+			munmap((void *) data, dataSize);
+		}
+	}
+
+	bool FastaReader::isGzip(const char * in, size_t size) {
+		return size >= 2 && (unsigned char) in[0] == 0x1f
+				&& (unsigned char) in[1] == 0x8b;
+	}
+
+	/**
+	 * A BGZF block is a gzip member with only the extra field set, holding
+	 * a "BC" subfield with the size of the block minus one. The last four
+	 * bytes of a member give its inflated size, so the blocks can be placed
+	 * in the output before any of them is inflated. Returns false if any
+	 * member is not a BGZF block.
+	 */
+	bool FastaReader::findBgzfBlocks(const char * in, size_t size,
+			vector<size_t>& blockStart, vector<size_t>& outputStart) {
+		const unsigned char * b = (const unsigned char *) in;
+		size_t at = 0;
+		size_t total = 0;
+		while (at < size) {
+			if (size - at < 18 || b[at] != 0x1f || b[at + 1] != 0x8b
+					|| b[at + 2] != 8 || b[at + 3] != 4) {
+				return false;
+			}
+			size_t extraLength = b[at + 10] | (b[at + 11] << 8);
+			size_t blockSize = 0;
+			size_t field = at + 12;
+			size_t extraEnd = field + extraLength;
+			if (extraEnd > size) {
+				return false;
+			}
+			while (field + 4 <= extraEnd) {
+				size_t fieldLength = b[field + 2] | (b[field + 3] << 8);
+				if (b[field] == 'B' && b[field + 1] == 'C' && fieldLength == 2
+						&& field + 6 <= extraEnd) {
+					blockSize = (b[field + 4] | (b[field + 5] << 8)) + 1;
+				}
+				field += 4 + fieldLength;
+			}
+			if (blockSize < extraLength + 20 || blockSize > size - at) {
+				return false;
+			}
+
+			size_t end = at + blockSize;
+			size_t inflatedSize = b[end - 4] | (b[end - 3] << 8)
+					| (b[end - 2] << 16) | ((size_t) b[end - 1] << 24);
+			blockStart.push_back(at);
+			outputStart.push_back(total);
+			total += inflatedSize;
+			at = end;
+		}
+		blockStart.push_back(size);
+		outputStart.push_back(total);
+		return true;
+	}
+
+	/**
+	 * Each block is inflated straight into its place in the output and
+	 * checked against its CRC.
+	 */
+	void FastaReader::inflateBgzf(const char * in,
+			const vector<size_t>& blockStart,
+			const vector<size_t>& outputStart) {
+		int blockCount = blockStart.size() - 1;
+		inflated.resize(outputStart.back());
+		char * out = &inflated[0];
+
+		int failure = Z_OK;
+#pragma omp parallel for schedule(dynamic) num_threads(std::max(1, (int) Util::CORE_NUM))
+		for (int k = 0; k < blockCount; k++) {
+			const unsigned char * block = (const unsigned char *) in
+					+ blockStart[k];
+			size_t extraLength = block[10] | (block[11] << 8);
+			size_t blockSize = blockStart[k + 1] - blockStart[k];
+			size_t outputSize = outputStart[k + 1] - outputStart[k];
+
+			z_stream stream;
+			stream.zalloc = Z_NULL;
+			stream.zfree = Z_NULL;
+			stream.opaque = Z_NULL;
+			int code = inflateInit2(&stream, -15);
+			if (code == Z_OK) {
+				stream.next_in = (Bytef *) block + 12 + extraLength;
+				stream.avail_in = blockSize - 20 - extraLength;
+				stream.next_out = (Bytef *) out + outputStart[k];
+				stream.avail_out = outputSize;
+				code = inflate(&stream, Z_FINISH);
+				if (code == Z_STREAM_END && stream.total_out == outputSize) {
+					const unsigned char * t = block + blockSize - 8;
+					uLong crc = t[0] | (t[1] << 8) | (t[2] << 16)
+							| ((uLong) t[3] << 24);
+					code = (crc == crc32(0, (Bytef *) out + outputStart[k],
+							outputSize)) ? Z_OK : Z_DATA_ERROR;
+				} else if (code == Z_OK || code == Z_STREAM_END) {
+					code = Z_DATA_ERROR;
+				}
+				inflateEnd(&stream);
+			}
+			if (code != Z_OK) {
+#pragma omp critical
+				failure = code;
+			}
+		}
+
+		if (failure != Z_OK) {
+			throwZlibError(failure);
+		}
+	}
+
+	/**
+	 * Inflates a gzip file of one or more members, growing the output as
+	 * needed. The size recorded at the end of the file starts the output.
+	 */
+	void FastaReader::inflateGzip(const char * in, size_t size) {
+		const unsigned char * t = (const unsigned char *) in + size - 4;
+		size_t guess = size >= 4 ? (t[0] | (t[1] << 8) | (t[2] << 16)
+				| ((size_t) t[3] << 24)) : 0;
+		inflated.resize(std::max(guess + 1, 4 * size));
+
+		// zlib counts in 32 bits, so large files are fed in pieces
+		const size_t piece = (size_t) 1 << 30;
+		z_stream stream;
+		stream.zalloc = Z_NULL;
+		stream.zfree = Z_NULL;
+		stream.opaque = Z_NULL;
+		stream.next_in = Z_NULL;
+		stream.avail_in = 0;
+		int code = inflateInit2(&stream, 15 + 16);
+		if (code != Z_OK) {
+			throwZlibError(code);
+		}
+
+		size_t inAt = 0;
+		size_t outAt = 0;
+		while (true) {
+			if (stream.avail_in == 0) {
+				size_t length = std::min(piece, size - inAt);
+				stream.next_in = (Bytef *) in + inAt;
+				stream.avail_in = length;
+				inAt += length;
+			}
+			if (outAt == inflated.size()) {
+				inflated.resize(2 * inflated.size());
+			}
+			size_t room = std::min(piece, inflated.size() - outAt);
+			stream.next_out = (Bytef *) &inflated[outAt];
+			stream.avail_out = room;
+
+			code = inflate(&stream, Z_NO_FLUSH);
+			outAt += room - stream.avail_out;
+
+			if (code == Z_STREAM_END) {
+				// Another member may follow; anything else ends the file
+				size_t next = inAt - stream.avail_in;
+				if (!isGzip(in + next, size - next)) {
+					break;
+				}
+				inflateReset(&stream);
+			} else if (code == Z_BUF_ERROR) {
+				if (stream.avail_in == 0 && inAt == size) {
+					inflateEnd(&stream);
+					throwZlibError(code);
+				}
+			} else if (code != Z_OK) {
+				inflateEnd(&stream);
+				throwZlibError(code);
+			}
+		}
+		inflateEnd(&stream);
+		inflated.resize(outAt);
+	}
+
+	void FastaReader::throwZlibError(int code) {
+		string msg("Cannot decompress ");
+		msg.append(fileName);
+		msg.append(". zlib code is: ");
+		msg.append(Util::int2string(code));
+		throw InvalidInputException(msg);
+	}
+
+	/**
+	 * Only a '>' at the start of a line begins a record. Anything before the
+	 * first header is ignored.
+	 */
+	void FastaReader::findRecords() {
+		size_t at = 0;
+		while (at < dataSize) {
+			const char * mark = (const char *) memchr(data + at, '>',
+					dataSize - at);
+			if (mark == NULL) {
+				break;
+			}
+			size_t start = mark - data;
+			at = start + 1;
+			if (start > 0 && data[start - 1] != '\n') {
+				continue;
+			}
+
+			if (!headerStart.empty()) {
+				sequenceEnd.push_back(start);
+			}
+			const char * newline = (const char *) memchr(mark, '\n',
+					dataSize - start);
+			size_t end = (newline == NULL) ? dataSize : newline - data;
+			headerStart.push_back(start);
+			headerEnd.push_back(end);
+			at = end;
+		}
+		if (!headerStart.empty()) {
+			sequenceEnd.push_back(dataSize);
+		}
+	}
+
+	size_t FastaReader::getSize() {
+		return dataSize;
+	}
+
+	int FastaReader::getRecordCount() {
+		return headerStart.size();
+	}
+
+	/**
+	 * The header line, including the '>'
+	 */
+	string FastaReader::getHeader(int record) {
+		return string(data + headerStart.at(record),
+				headerEnd.at(record) - headerStart.at(record));
+	}
+
+	size_t FastaReader::getSequenceStart(int record) {
+		return std::min(headerEnd.at(record) + 1, sequenceEnd.at(record));
+	}
+
+	size_t FastaReader::getSequenceEnd(int record) {
+		return sequenceEnd.at(record);
+	}
+
+	/**
+	 * Points line at the line starting at offset, without its newline, and
+	 * moves offset to the next line. Returns false once offset reaches end.
+	 */
+	bool FastaReader::nextLine(size_t& offset, size_t end, const char *& line,
+			size_t& length) {
+		if (offset >= end) {
+			return false;
+		}
+		line = data + offset;
+		const char * newline = (const char *) memchr(line, '\n', end - offset);
+		if (newline == NULL) {
+			length = end - offset;
+			offset = end;
+		} else {
+			length = newline - line;
+			offset += length + 1;
+		}
+		return true;
+	}
+
+} /* namespace utility */
@@ -0,0 +1,65 @@
+/*
+ * FastaReader.h
+ *
+ * Reads a FASTA file through a read-only memory map. Headers and lines are
+ * found with memchr, and sequence lines are handed out as pointers into the
+ * map, so callers copy the bytes straight into their own buffers.
+ *
+ * A header is a line that starts with '>'. The sequence of a record runs
+ * from the line after its header to the next header or the end of the
+ * file; the offsets of both ends are exposed so that a record can be read
+ * in pieces.
+ *
+ * Gzip files are inflated into memory first. A BGZF file, a series of
+ * gzip members that record their own sizes, has its blocks inflated in
+ * parallel.
+ */
+
+#ifndef FASTAREADER_H_
+#define FASTAREADER_H_
+
+#include <string>
+#include <vector>
+#include <stddef.h>
+
+using namespace std;
+
+namespace utility {
+
+	class FastaReader {
+	private:
+		string fileName;
+		const char * data;
+		size_t dataSize;
+		// For each record: where its header starts, where it ends (before
+		// the newline) and where its sequence ends
+		vector<size_t> headerStart;
+		vector<size_t> headerEnd;
+		vector<size_t> sequenceEnd;
+		// Holds the sequence file once inflated; empty for a mapped file
+		string inflated;
+
+		static bool isGzip(const char *, size_t);
+		bool findBgzfBlocks(const char *, size_t, vector<size_t>&,
+				vector<size_t>&);
+		void inflateBgzf(const char *, const vector<size_t>&,
+				const vector<size_t>&);
+		void inflateGzip(const char *, size_t);
+		void throwZlibError(int);
+		void findRecords();
+
+	public:
+		FastaReader(string);
+		virtual ~FastaReader();
+
+		size_t getSize();
+		int getRecordCount();
+		string getHeader(int);
+		size_t getSequenceStart(int);
+		size_t getSequenceEnd(int);
+		bool nextLine(size_t&, size_t, const char *&, size_t&);
+	};
+
+} /* namespace utility */
+
+#endif /* FASTAREADER_H_ */
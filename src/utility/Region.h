@@ -0,0 +1,41 @@
+/*
+ * Region.h
+ *
+ * A region of a sequence as a plain value: an inclusive [start,end] pair.
+ * Lists of regions are vectors of these, stored contiguously, so decoding,
+ * merging and scoring them neither allocates per region nor goes through
+ * virtual getters. ILocation remains for the interfaces that hand out
+ * pointers.
+ */
+
+#ifndef REGION_H_
+#define REGION_H_
+
+#include <string>
+
+namespace utility {
+
+	struct Region {
+		int start;
+		int end;
+
+		Region() :
+				start(0), end(0) {
+		}
+
+		Region(int startIn, int endIn) :
+				start(startIn), end(endIn) {
+		}
+
+		int getLength() const {
+			return end - start + 1;
+		}
+
+		std::string toString() const {
+			return std::to_string(start) + "-" + std::to_string(end);
+		}
+	};
+
+} /* namespace utility */
+
+#endif /* REGION_H_ */
@@ -267,8 +267,14 @@ void Util::readChromList(string genomeDir, vector<string> *chromList,
   while (entry)
   {
     string file(entry->d_name);
+    // A gzip file is listed under the extension it has without ".gz"
+    if (file.size() > 3 && file.compare(file.size() - 3, 3, ".gz") == 0)
+    {
+      file.erase(file.size() - 3);
+    }
     // Credit: http://stackoverflow.com/questions/51949/how-to-get-file-extension-from-string-in-c
-    if (file.substr(file.find_last_of(".") + 1) == ext)
+    string fileExt = file.substr(file.find_last_of(".") + 1);
+    if (fileExt == ext || (ext == "fa" && fileExt == "fasta"))
     {
       chromList->push_back(genomeDir + fileSeparator + entry->d_name);
     }
@@ -496,78 +502,82 @@ bool Util::merge(ILocation *a, ILocation *b)
   return (isStartWithin || isEndWithin || isIncluding || isIncluded || isAdjacent);
 }
 
-void Util::merge(std::vector<Location *> *regionList, int gapLen)
+/*
+ * Merges each region into the last region kept before it if the two overlap
+ * or are at most gapLen apart, in one pass: kept regions are moved down over
+ * the merged ones, which are deleted, and the list is cut once at the end.
+ * The first from regions are taken to be merged already, as a list returned
+ * by an earlier call is, so a list that only grew at the end is merged from
+ * where it grew.
+ */
+template<class T>
+static void mergeRegions(std::vector<T *> *regionList, int gapLen, int from)
 {
   int regionCount = regionList->size();
-  int gg = 0;
-  while (gg < regionCount)
+  if (regionCount < 2)
   {
-    ILocation *region = regionList->at(gg);
+    return;
+  }
+  int last = std::max(from, 1) - 1;
+  for (int gg = last + 1; gg < regionCount; gg++)
+  {
+    T *region = regionList->at(gg);
+    T *pRegion = regionList->at(last);
 
     int regionStart = region->getStart();
     int regionEnd = region->getEnd();
+    int pStart = pRegion->getStart();
+    int pEnd = pRegion->getEnd();
 
-    if (gg > 0)
+    if (Util::isOverlapping(pStart, pEnd, regionStart, regionEnd) || regionStart - pEnd <= gapLen)
     {
-      ILocation *pRegion = regionList->at(gg - 1);
-      int pStart = pRegion->getStart();
-      int pEnd = pRegion->getEnd();
-
-      if (Util::isOverlapping(pStart, pEnd, regionStart, regionEnd) || regionStart - pEnd <= gapLen)
-      {
-        pRegion->setEnd(regionEnd > pEnd ? regionEnd : pEnd);
-        regionList->erase(regionList->begin() + gg);
-        delete region;
-        regionCount = regionList->size();
-      }
-      else
-      {
-        gg++;
-      }
+      pRegion->setEnd(regionEnd > pEnd ? regionEnd : pEnd);
+      delete region;
     }
-
-    if (gg == 0)
+    else
     {
-      gg++;
+      (*regionList)[++last] = region;
     }
   }
+  regionList->resize(last + 1);
 }
 
-void Util::merge(std::vector<ILocation *> *regionList, int gapLen)
+void Util::merge(std::vector<Location *> *regionList, int gapLen, int from)
 {
-  int regionCount = regionList->size();
-  int gg = 0;
-  while (gg < regionCount)
-  {
-    ILocation *region = regionList->at(gg);
+  mergeRegions(regionList, gapLen, from);
+}
 
-    int regionStart = region->getStart();
-    int regionEnd = region->getEnd();
+void Util::merge(std::vector<ILocation *> *regionList, int gapLen, int from)
+{
+  mergeRegions(regionList, gapLen, from);
+}
 
-    if (gg > 0)
+/*
+ * The same merge on regions held by value; nothing needs to be freed
+ */
+void Util::merge(std::vector<Region> *regionList, int gapLen, int from)
+{
+  int regionCount = regionList->size();
+  if (regionCount < 2)
+  {
+    return;
+  }
+  Region *regions = regionList->data();
+  int last = std::max(from, 1) - 1;
+  for (int gg = last + 1; gg < regionCount; gg++)
+  {
+    Region &pRegion = regions[last];
+    const Region &region = regions[gg];
+    if (Util::isOverlapping(pRegion.start, pRegion.end, region.start, region.end) || region.start - pRegion.end <= gapLen)
     {
-      ILocation *pRegion = regionList->at(gg - 1);
-      int pStart = pRegion->getStart();
-      int pEnd = pRegion->getEnd();
-
-      if (Util::isOverlapping(pStart, pEnd, regionStart, regionEnd) || regionStart - pEnd <= gapLen)
-      {
-        pRegion->setEnd(regionEnd > pEnd ? regionEnd : pEnd);
-        regionList->erase(regionList->begin() + gg);
-        delete region;
-        regionCount = regionList->size();
-      }
-      else
-      {
-        gg++;
-      }
+      pRegion.end = region.end > pRegion.end ? region.end : pRegion.end;
     }
-
-    if (gg == 0)
+    else
     {
-      gg++;
+      regions[++last] = region;
     }
   }
+  regionList->resize(last + 1);
 }
 
 /**
@@ -1014,6 +1024,157 @@ std::vector<Location *> *Util::locationSubtract(const std::vector<ILocation *> *
   return subtractList;
 }
 
+/*
+ * Sums, without creating any region, the lengths of the regions that
+ * locationIntersect(A, B) and locationSubtract(A, B) would return, and of
+ * the parts of B left out of the intersection. A holds the predicted
+ * regions and B the true ones, both sorted and non-overlapping; the sums
+ * are the true positive, false positive and false negative base counts.
+ * Both sweeps keep the boundary conventions of the functions they stand
+ * for, so the counts match the lists those return.
+ */
+void Util::overlapLengths(const std::vector<Region> *A,
+                          const std::vector<Region> *B,
+                          int &tp, int &fp, int &fn)
+{
+  tp = 0;
+  fp = 0;
+
+  // As locationIntersect does
+  int indexA = 0;
+  int indexB = 0;
+  while (indexA < A->size() && indexB < B->size())
+  {
+    const Region &a = (*A)[indexA];
+    const Region &b = (*B)[indexB];
+    int s = max(a.start, b.start);
+    int e = min(a.end, b.end);
+    if (Util::isOverlapping(a.start, a.end, b.start, b.end) && s != e)
+    {
+      tp += e - s + 1;
+      if (b.end <= a.end)
+      {
+        indexB++;
+      }
+      else
+      {
+        indexA++;
+      }
+    }
+    else if (b.end <= a.start)
+    {
+      indexB++;
+    }
+    else if (a.end <= b.end)
+    {
+      indexA++;
+    }
+    else
+    {
+      throw std::exception();
+    }
+  }
+
+  fn = sumTotalLength(B) - tp;
+
+  // As locationSubtract does, on the bounds of the current regions only.
+  // Once B runs out, the rest of A counts whole, including the current
+  // region even if its start has moved.
+  if (A->empty())
+  {
+    return;
+  }
+  if (B->empty())
+  {
+    fp = sumTotalLength(A);
+    return;
+  }
+  indexA = 0;
+  indexB = 0;
+  int aStart = (*A)[0].start;
+  int aEnd = (*A)[0].end;
+  int bStart = (*B)[0].start;
+  int bEnd = (*B)[0].end;
+  bool isRestOfA = false;
+  while (true)
+  {
+    bool isNextA = false;
+    bool isNextB = false;
+    // After A's region ends inside B's, locationSubtract also moves past
+    // B's region if the next region of A starts after it: with > if A's
+    // region started before B's, with >= otherwise
+    bool isStrict = false;
+    bool isCheckB = false;
+    if (Util::isOverlapping(aStart, aEnd, bStart, bEnd))
+    {
+      if (aStart < bStart)
+      {
+        fp += bStart - aStart + 1;
+        if (aEnd <= bEnd)
+        {
+          isNextA = true;
+          isCheckB = true;
+          isStrict = true;
+        }
+        else
+        {
+          aStart = bEnd;
+        }
+      }
+      else if (aEnd <= bEnd)
+      {
+        isNextA = true;
+        isCheckB = true;
+      }
+      else
+      {
+        aStart = bEnd;
+        isNextB = true;
+      }
+    }
+    else if (aEnd < bStart)
+    {
+      fp += aEnd - aStart + 1;
+      isNextA = true;
+    }
+    else
+    {
+      isNextB = true;
+    }
+
+    if (isNextA)
+    {
+      if (++indexA >= A->size())
+      {
+        break;
+      }
+      aStart = (*A)[indexA].start;
+      aEnd = (*A)[indexA].end;
+      if (isCheckB)
+      {
+        isNextB = isStrict ? aStart > bEnd : aStart >= bEnd;
+      }
+    }
+    if (isNextB)
+    {
+      if (++indexB >= B->size())
+      {
+        isRestOfA = true;
+        break;
+      }
+      bStart = (*B)[indexB].start;
+      bEnd = (*B)[indexB].end;
+    }
+  }
+  if (isRestOfA)
+  {
+    for (int i = indexA; i < A->size(); i++)
+    {
+      fp += (*A)[i].getLength();
+    }
+  }
+}
+
 void Util::writeFasta(const string &sequence, const string &header,
                       const string &outputFile)
 {
@@ -1056,6 +1217,16 @@ int Util::sumTotalLength(const vector<Location *> *list)
   return sum;
 }
 
+int Util::sumTotalLength(const vector<Region> *list)
+{
+  int sum = 0;
+  for (const Region &region : *list)
+  {
+    sum += region.getLength();
+  }
+  return sum;
+}
+
 string Util::getLargestFile(const string &dirName)
 {
   /*
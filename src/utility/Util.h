@@ -9,6 +9,7 @@
 #define UTIL_H_
 
 #include "Location.h"
+#include "Region.h"
 #include "../exception/FileDoesNotExistException.h"
 #include "../exception/InvalidInputException.h"
 
@@ -63,8 +64,9 @@ namespace utility {
 		static bool isOverlapping(int, int, int, int);
 		static bool isOverlapping(const ILocation * a, const ILocation * b);
 		static bool merge(utility::ILocation*, utility::ILocation*);
-		static void merge(std::vector<Location *> *, int gapLen = 0);
-		static void merge(std::vector<ILocation *> *, int gapLen = 0);
+		static void merge(std::vector<Location *> *, int gapLen = 0, int from = 0);
+		static void merge(std::vector<ILocation *> *, int gapLen = 0, int from = 0);
+		static void merge(std::vector<Region> *, int gapLen = 0, int from = 0);
 		static void revCompDig(string *, string *);
 		static void revCompDig(const char* sequence, int, int, string *);
 		static std::string oneDigitToNuc(const std::string&);
@@ -76,11 +78,14 @@ namespace utility {
 			const std::vector<ILocation *> *);
 		static std::vector<Location *> * locationSubtract(const std::vector<ILocation *>  *, 
 			const std::vector<ILocation *> *);
+		static void overlapLengths(const std::vector<Region> *,
+			const std::vector<Region> *, int&, int&, int&);
 
 		static void writeFasta(const string&, const string&, const string&);
 
 		static int sumTotalLength(const vector<ILocation *> *);
 		static int sumTotalLength(const vector<Location *> *);
+		static int sumTotalLength(const vector<Region> *);
 		static string getLargestFile(const string&);
 
 	/**